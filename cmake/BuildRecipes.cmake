@@ -26,6 +26,8 @@ set(BUILD_SHARED_LIBS ${UNTITLED_BUILD_SHARED_LIBS})
 option(UNTITLED_EXPORT_COMPILE_COMMANDS "Export Compilation Commands database (ON, by default)" ON)
 set(CMAKE_EXPORT_COMPILE_COMMANDS ${UNTITLED_EXPORT_COMPILE_COMMANDS})
 
+option(UNTITLED_BUILD_BENCHMARKS "Build the benchmark executables (ON, by default)" ON)
+
 
 # Build Recipes
 
@@ -137,3 +139,48 @@ function(add_untitled_utest )
     COMMAND ${ARGS_NAME})
 
 endfunction()
+
+function(add_untitled_benchmark )
+
+  if(NOT UNTITLED_BUILD_BENCHMARKS)
+    return()
+  endif()
+
+  set(options "")
+  set(oneValueArgs NAME)
+  set(multiValueArgs SOURCES HEADERS INCLUDE_DIRS PUBLIC_LIBS PRIVATE_LIBS LIBRARY_DIRS DEFINITIONS)
+  cmake_parse_arguments(ARGS "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+  add_executable(${ARGS_NAME})
+
+  target_sources(${ARGS_NAME}
+    PRIVATE
+      ${ARGS_HEADERS}
+      ${ARGS_SOURCES})
+
+  target_include_directories(${ARGS_NAME}
+    PRIVATE
+      ${ARGS_INCLUDE_DIRS})
+
+  # n.b. the build type is recorded in the report, as results are only comparable between equivalent builds
+  target_compile_definitions(${ARGS_NAME}
+    PUBLIC
+      UNTITLED_BENCH_BUILD_TYPE="$<IF:$<CONFIG:>,unspecified,$<CONFIG>>"
+      ${ARGS_DEFINITIONS})
+
+  target_link_libraries(${ARGS_NAME}
+    PUBLIC
+      ${ARGS_PUBLIC_LIBS}
+    PRIVATE
+      ${ARGS_PRIVATE_LIBS})
+
+  set_target_properties(${ARGS_NAME}
+    PROPERTIES
+      POSITION_INDEPENDENT_CODE ON
+      ARCHIVE_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/lib"
+      LIBRARY_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/lib"
+      RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/bin/bench")
+
+  # n.b. benchmarks are not registered as tests, as they are meant to be run (and compared) explicitly
+
+endfunction()
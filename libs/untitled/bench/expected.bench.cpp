@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "untitled/expected.hpp"
+
+#include <stdexcept>
+
+#include "harness.hpp"
+
+namespace {
+
+// n.b. not inlined, so that the cost of returning the result is measured
+
+[[gnu::noinline]] untitled::expected<int, long> checked_increment(int v) {
+  if (v >= 0) {
+    return untitled::expected<int, long>{v + 1};
+  }
+  return untitled::expected<int, long>{untitled::unexpected<long>{long(v)}};
+}
+
+[[gnu::noinline]] int throwing_increment(int v) {
+  if (v >= 0) {
+    return v + 1;
+  }
+  throw std::invalid_argument("negative value");
+}
+
+void expected_success_path(untitled::bench::context& ctx) {
+  int v = 0;
+  for (auto _ : ctx) {
+    v = checked_increment(v).value();
+    untitled::bench::do_not_optimize(v);
+  }
+}
+
+void expected_error_path(untitled::bench::context& ctx) {
+  long e = 0;
+  int v  = -1;
+  for (auto _ : ctx) {
+    e += checked_increment(v).error();
+    untitled::bench::do_not_optimize(e);
+  }
+}
+
+// n.b. exceptions are used as baseline
+
+void exception_success_path(untitled::bench::context& ctx) {
+  int v = 0;
+  for (auto _ : ctx) {
+    v = throwing_increment(v);
+    untitled::bench::do_not_optimize(v);
+  }
+}
+
+void exception_error_path(untitled::bench::context& ctx) {
+  long e = 0;
+  int v  = -1;
+  for (auto _ : ctx) {
+    try {
+      throwing_increment(v);
+    }
+    catch (const std::invalid_argument&) {
+      ++e;
+    }
+    untitled::bench::do_not_optimize(e);
+  }
+}
+
+UNTITLED_BENCHMARK("expected/success_path", expected_success_path);
+UNTITLED_BENCHMARK("expected/error_path", expected_error_path);
+UNTITLED_BENCHMARK("expected/exception_success_path", exception_success_path);
+UNTITLED_BENCHMARK("expected/exception_error_path", exception_error_path);
+
+} // namespace
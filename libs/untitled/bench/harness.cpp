@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "harness.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef UNTITLED_BENCH_BUILD_TYPE
+  #define UNTITLED_BENCH_BUILD_TYPE "unknown"
+#endif
+
+namespace untitled::bench {
+
+namespace {
+
+struct options {
+  std::string filter;
+  std::string output;
+  double min_time    = 0.2; // seconds, per repetition
+  size_t repetitions = 5;
+  bool list          = false;
+};
+
+struct result {
+  std::string name;
+  size_t iterations;
+  size_t items_per_iteration;
+  std::vector<double> ns_per_item; // n.b. one entry per repetition
+  std::map<std::string, double> counters;
+};
+
+std::vector<std::pair<std::string, benchmark_t>>& registry() {
+  static std::vector<std::pair<std::string, benchmark_t>> benchmarks;
+  return benchmarks;
+}
+
+void usage(const char* program) {
+  std::cerr << "usage: " << program << " [--filter <substring>] [--min-time <seconds>] [--repetitions <n>] [--output <file>] [--list]\n";
+}
+
+bool parse(int argc, char** argv, options& opts) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--list") {
+      opts.list = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      return false;
+    }
+    std::string value = argv[++i];
+    if (arg == "--filter") {
+      opts.filter = value;
+    }
+    else if (arg == "--output") {
+      opts.output = value;
+    }
+    else if (arg == "--min-time") {
+      opts.min_time = std::stod(value);
+    }
+    else if (arg == "--repetitions") {
+      opts.repetitions = std::max<size_t>(1, std::stoul(value));
+    }
+    else {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::chrono::nanoseconds run_once(const benchmark_t& benchmark, context& ctx) {
+  benchmark(ctx);
+  return ctx.elapsed();
+}
+
+result run(const std::string& name, const benchmark_t& benchmark, const options& opts) {
+  auto min_time = std::chrono::duration<double>(opts.min_time);
+
+  // Grow the number of iterations until a single run lasts, at least, the minimum time
+  size_t iterations = 1;
+  while (true) {
+    context ctx{iterations};
+    auto elapsed = std::chrono::duration<double>(run_once(benchmark, ctx));
+    if (elapsed >= min_time || iterations >= 1'000'000'000) {
+      break;
+    }
+    double factor = elapsed.count() > 0 ? 1.4 * min_time / elapsed : 100.0;
+    iterations    = std::max(iterations + 1, static_cast<size_t>(iterations * std::clamp(factor, 2.0, 100.0)));
+  }
+
+  result r{name, iterations, 1, {}, {}};
+  for (size_t i = 0; i < opts.repetitions; ++i) {
+    context ctx{iterations};
+    auto elapsed          = run_once(benchmark, ctx);
+    r.items_per_iteration = ctx.items_per_iteration();
+    r.counters            = ctx.counters();
+    r.ns_per_item.push_back(double(elapsed.count()) / double(iterations * ctx.items_per_iteration()));
+  }
+  std::sort(r.ns_per_item.begin(), r.ns_per_item.end());
+  return r;
+}
+
+std::string quoted(const std::string& s) {
+  std::string q = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      q += '\\';
+    }
+    q += c;
+  }
+  return q + "\"";
+}
+
+std::string timestamp() {
+  std::time_t now = std::time(nullptr);
+  std::ostringstream os;
+  os << std::put_time(std::gmtime(&now), "%Y-%m-%dT%H:%M:%SZ");
+  return os.str();
+}
+
+void report(std::ostream& os, const std::vector<result>& results, const options& opts) {
+  os << std::setprecision(6);
+  os << "{\n";
+  os << "  \"context\": {\n";
+  os << "    \"date\": " << quoted(timestamp()) << ",\n";
+  os << "    \"build_type\": " << quoted(UNTITLED_BENCH_BUILD_TYPE) << ",\n";
+  os << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+  os << "    \"min_time\": " << opts.min_time << ",\n";
+  os << "    \"repetitions\": " << opts.repetitions << "\n";
+  os << "  },\n";
+  os << "  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& r = results[i];
+    const auto& v = r.ns_per_item;
+    double median = v[v.size() / 2];
+    os << (i == 0 ? "\n" : ",\n");
+    os << "    {\n";
+    os << "      \"name\": " << quoted(r.name) << ",\n";
+    os << "      \"iterations\": " << r.iterations << ",\n";
+    os << "      \"items_per_iteration\": " << r.items_per_iteration << ",\n";
+    os << "      \"ns_per_item\": {\"min\": " << v.front() << ", \"median\": " << median << ", \"max\": " << v.back() << "},\n";
+    os << "      \"items_per_second\": " << (median > 0 ? 1e9 / median : 0.0) << ",\n";
+    os << "      \"counters\": {";
+    for (auto it = r.counters.begin(); it != r.counters.end(); ++it) {
+      os << (it == r.counters.begin() ? "" : ", ") << quoted(it->first) << ": " << it->second;
+    }
+    os << "}\n";
+    os << "    }";
+  }
+  os << "\n  ]\n";
+  os << "}\n";
+}
+
+} // namespace
+
+bool register_benchmark(const std::string& name, benchmark_t benchmark) {
+  registry().emplace_back(name, std::move(benchmark));
+  return true;
+}
+
+int run_main(int argc, char** argv) {
+  options opts;
+  if (!parse(argc, argv, opts)) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  auto benchmarks = registry();
+  std::sort(benchmarks.begin(), benchmarks.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  std::vector<result> results;
+  for (const auto& [name, benchmark] : benchmarks) {
+    if (name.find(opts.filter) == std::string::npos) {
+      continue;
+    }
+    if (opts.list) {
+      std::cout << name << "\n";
+      continue;
+    }
+    // n.b. progress goes to stderr, so that stdout only holds the JSON report
+    std::cerr << std::left << std::setw(56) << name << std::flush;
+    results.push_back(run(name, benchmark, opts));
+    std::cerr << std::right << std::setw(14) << std::fixed << std::setprecision(2) << results.back().ns_per_item[opts.repetitions / 2] << " ns/item\n";
+  }
+  if (opts.list) {
+    return EXIT_SUCCESS;
+  }
+
+  if (opts.output.empty()) {
+    report(std::cout, results, opts);
+  }
+  else {
+    std::ofstream out{opts.output};
+    report(out, results, opts);
+    if (!out) {
+      std::cerr << "unable to write " << opts.output << "\n";
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+} // namespace untitled::bench
@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#ifndef UNTITLED_BENCH_HARNESS_HPP
+#define UNTITLED_BENCH_HARNESS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace untitled::bench {
+
+// Prevents the compiler from optimising away the computation of v
+template <typename T>
+inline void do_not_optimize(const T& v) {
+  asm volatile("" : : "r,m"(v) : "memory");
+}
+
+// State of a single benchmark run, which is iterated to execute the (timed) operations:
+//
+//   void bm(context& ctx) {
+//     ... setup (not timed) ...
+//     for (auto _ : ctx) {
+//       ... operation (timed) ...
+//     }
+//     ... teardown (not timed) ...
+//   }
+
+class context {
+public:
+  using clock_t = std::chrono::steady_clock;
+
+  explicit context(size_t iterations) : iterations_{iterations} {}
+
+  // n.b. marked, so that unused loop variables do not trigger warnings
+  struct [[maybe_unused]] iteration {};
+
+  class iterator {
+  public:
+    iterator(context* ctx, size_t remaining) : ctx_{ctx}, remaining_{remaining} {}
+
+    iteration operator*() const { return {}; }
+    iterator& operator++() {
+      --remaining_;
+      return *this;
+    }
+    bool operator!=(const iterator&) {
+      if (remaining_ == 0) {
+        ctx_->stop_ = clock_t::now();
+        return false;
+      }
+      return true;
+    }
+
+  private:
+    context* ctx_;
+    size_t remaining_;
+  };
+
+  iterator begin() {
+    start_ = clock_t::now();
+    return {this, iterations_};
+  }
+  iterator end() { return {this, 0}; }
+
+  size_t iterations() const { return iterations_; }
+  std::chrono::nanoseconds elapsed() const { return stop_ - start_; }
+
+  // Number of items processed by each iteration (e.g. tasks in a batch), used to report per item costs
+  void set_items_per_iteration(size_t n) { items_per_iteration_ = n; }
+  size_t items_per_iteration() const { return items_per_iteration_; }
+
+  // Additional (benchmark specific) measurements, reported as is
+  void set_counter(const std::string& name, double value) { counters_[name] = value; }
+  const std::map<std::string, double>& counters() const { return counters_; }
+
+private:
+  size_t iterations_;
+  size_t items_per_iteration_ = 1;
+  clock_t::time_point start_  = {};
+  clock_t::time_point stop_   = {};
+  std::map<std::string, double> counters_;
+};
+
+using benchmark_t = std::function<void(context&)>;
+
+// Registers a benchmark, to be run by run_main
+bool register_benchmark(const std::string& name, benchmark_t benchmark);
+
+// Runs the registered benchmarks, according to the command line options, and reports the results as JSON
+int run_main(int argc, char** argv);
+
+} // namespace untitled::bench
+
+#define UNTITLED_BENCH_CONCAT_(a, b) a##b
+#define UNTITLED_BENCH_CONCAT(a, b) UNTITLED_BENCH_CONCAT_(a, b)
+
+// Registers a benchmark function, at static initialisation time
+#define UNTITLED_BENCHMARK(name, ...) \
+  [[maybe_unused]] static const bool UNTITLED_BENCH_CONCAT(untitled_benchmark_, __LINE__) = ::untitled::bench::register_benchmark(name, __VA_ARGS__)
+
+#endif
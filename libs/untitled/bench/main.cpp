@@ -0,0 +1,13 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "harness.hpp"
+
+int main(int argc, char** argv) {
+  return untitled::bench::run_main(argc, argv);
+}
@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "untitled/channel.hpp"
+#include "untitled/thread_pool.hpp"
+
+namespace {
+
+// Bounces a message back and forth between two threads -- i.e. the round-trip cost of the queue
+
+void ping_pong_thread_safe_queue(untitled::bench::context& ctx) {
+  untitled::thread_safe_queue<int> ping;
+  untitled::thread_safe_queue<int> pong;
+
+  std::thread partner{[&ping, &pong]() {
+    int v = 0;
+    while (ping.pop(v)) {
+      pong.push(v);
+    }
+  }};
+
+  int v = 0;
+  for (auto _ : ctx) {
+    ping.push(v);
+    pong.pop(v);
+  }
+
+  ping.cancel();
+  partner.join();
+}
+
+void ping_pong_spsc_channel(untitled::bench::context& ctx) {
+  untitled::spsc_channel<int, true> ping{64};
+  untitled::spsc_channel<int, true> pong{64};
+
+  std::thread partner{[&ping, &pong]() {
+    int v = 0;
+    while (ping.pop(v)) {
+      pong.push(v);
+    }
+  }};
+
+  int v = 0;
+  for (auto _ : ctx) {
+    ping.push(v);
+    pong.pop(v);
+  }
+
+  ping.cancel();
+  partner.join();
+}
+
+// Streams messages from one thread to another, in batches -- i.e. the throughput of the channel
+
+void stream_spsc_channel(untitled::bench::context& ctx) {
+  static constexpr size_t batch_size = 256;
+
+  untitled::spsc_channel<int, true> channel{4096};
+
+  std::thread consumer{[&channel]() {
+    std::vector<int> batch(batch_size);
+    while (channel.wait_pop_n(batch.begin(), batch.size()) > 0) {
+    }
+  }};
+
+  std::vector<int> batch(batch_size, 42);
+  ctx.set_items_per_iteration(batch_size);
+  for (auto _ : ctx) {
+    size_t pushed = 0;
+    while (pushed < batch_size) {
+      pushed += channel.push_n(batch.begin() + pushed, batch_size - pushed);
+    }
+  }
+
+  channel.cancel();
+  consumer.join();
+}
+
+UNTITLED_BENCHMARK("queue/ping_pong/thread_safe_queue", ping_pong_thread_safe_queue);
+UNTITLED_BENCHMARK("queue/ping_pong/spsc_channel", ping_pong_spsc_channel);
+UNTITLED_BENCHMARK("queue/stream/spsc_channel", stream_spsc_channel);
+
+} // namespace
@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "untitled/thread_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+
+namespace {
+
+// Submits a single task, and waits (spinning) until it runs -- i.e. the submit-to-run latency
+void submit_to_run_latency(untitled::bench::context& ctx) {
+  untitled::thread_pool pool{1};
+
+  std::atomic<bool> done{false};
+  std::chrono::nanoseconds to_start{0};
+
+  for (auto _ : ctx) {
+    done.store(false, std::memory_order_relaxed);
+    auto submitted = std::chrono::steady_clock::now();
+    pool.submit([&done, &to_start, submitted]() {
+      to_start += std::chrono::steady_clock::now() - submitted;
+      done.store(true, std::memory_order_release);
+    });
+    while (!done.load(std::memory_order_acquire)) {
+    }
+  }
+
+  ctx.set_counter("submit_to_start_ns", double(to_start.count()) / double(ctx.iterations()));
+}
+
+// Submits batches of (trivial) tasks, and waits until all of them run -- i.e. the throughput of the pool
+void throughput(untitled::bench::context& ctx, size_t n_threads) {
+  static constexpr size_t batch_size = 1'000;
+
+  untitled::thread_pool pool{n_threads};
+  std::atomic<size_t> count{0};
+
+  ctx.set_items_per_iteration(batch_size);
+  for (auto _ : ctx) {
+    count.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < batch_size; ++i) {
+      pool.submit([&count]() { count.fetch_add(1, std::memory_order_release); });
+    }
+    while (count.load(std::memory_order_acquire) != batch_size) {
+    }
+  }
+}
+
+// Fans out a batch of (trivial) tasks, and waits until all of them run -- i.e. the cost of the submission method
+
+void fan_out_submit(untitled::bench::context& ctx) {
+  static constexpr size_t batch_size = 10'000;
+
+  untitled::thread_pool pool{std::thread::hardware_concurrency()};
+  std::atomic<size_t> count{0};
+
+  ctx.set_items_per_iteration(batch_size);
+  for (auto _ : ctx) {
+    count.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < batch_size; ++i) {
+      pool.submit([&count]() { count.fetch_add(1, std::memory_order_release); });
+    }
+    while (count.load(std::memory_order_acquire) != batch_size) {
+    }
+  }
+}
+
+void fan_out_submit_bulk(untitled::bench::context& ctx) {
+  static constexpr size_t batch_size = 10'000;
+
+  untitled::thread_pool pool{std::thread::hardware_concurrency()};
+  std::atomic<size_t> count{0};
+
+  ctx.set_items_per_iteration(batch_size);
+  for (auto _ : ctx) {
+    count.store(0, std::memory_order_relaxed);
+    std::vector<untitled::thread_pool::task_t> tasks(batch_size, [&count]() { count.fetch_add(1, std::memory_order_release); });
+    pool.submit_bulk(std::make_move_iterator(tasks.begin()), std::make_move_iterator(tasks.end()));
+    while (count.load(std::memory_order_acquire) != batch_size) {
+    }
+  }
+}
+
+void fan_out_submit_n(untitled::bench::context& ctx) {
+  static constexpr size_t batch_size = 10'000;
+
+  untitled::thread_pool pool{std::thread::hardware_concurrency()};
+  std::atomic<size_t> count{0};
+
+  ctx.set_items_per_iteration(batch_size);
+  for (auto _ : ctx) {
+    count.store(0, std::memory_order_relaxed);
+    pool.submit_n(batch_size, [&count](size_t) { count.fetch_add(1, std::memory_order_release); });
+    while (count.load(std::memory_order_acquire) != batch_size) {
+    }
+  }
+}
+
+UNTITLED_BENCHMARK("thread_pool/submit_to_run_latency", submit_to_run_latency);
+
+UNTITLED_BENCHMARK("thread_pool/throughput/threads:1", [](auto& ctx) { throughput(ctx, 1); });
+UNTITLED_BENCHMARK("thread_pool/throughput/threads:2", [](auto& ctx) { throughput(ctx, 2); });
+UNTITLED_BENCHMARK("thread_pool/throughput/threads:4", [](auto& ctx) { throughput(ctx, 4); });
+UNTITLED_BENCHMARK("thread_pool/throughput/threads:8", [](auto& ctx) { throughput(ctx, 8); });
+UNTITLED_BENCHMARK("thread_pool/throughput/threads:hardware", [](auto& ctx) { throughput(ctx, std::thread::hardware_concurrency()); });
+
+UNTITLED_BENCHMARK("thread_pool/fan_out/submit", fan_out_submit);
+UNTITLED_BENCHMARK("thread_pool/fan_out/submit_bulk", fan_out_submit_bulk);
+UNTITLED_BENCHMARK("thread_pool/fan_out/submit_n", fan_out_submit_n);
+
+} // namespace
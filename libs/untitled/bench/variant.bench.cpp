@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "untitled/variant.hpp"
+
+#include <random>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "harness.hpp"
+
+namespace {
+
+template <size_t I>
+struct alternative {
+  int value;
+};
+
+template <template <typename...> typename Variant, typename Sequence>
+struct make_variant;
+
+template <template <typename...> typename Variant, size_t... I>
+struct make_variant<Variant, std::index_sequence<I...>> {
+  using type = Variant<alternative<I>...>;
+
+  // Creates n variants, holding (pseudo) randomly selected alternatives
+  static std::vector<type> random(size_t n) {
+    using factory_t                     = type (*)(int);
+    static constexpr factory_t create[] = {[](int v) { return type{alternative<I>{v}}; }...};
+
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<size_t> dist{0, sizeof...(I) - 1};
+
+    std::vector<type> variants;
+    variants.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      variants.push_back(create[dist(gen)](int(i)));
+    }
+    return variants;
+  }
+};
+
+// Visits a collection of variants, holding randomly selected alternatives -- i.e. the cost of the visit dispatch
+
+template <size_t N>
+void visit_untitled_variant(untitled::bench::context& ctx) {
+  static constexpr size_t n_variants = 1'024;
+
+  auto variants = make_variant<untitled::variant, std::make_index_sequence<N>>::random(n_variants);
+
+  long sum     = 0;
+  auto visitor = [&sum](auto& a) { sum += a.value; };
+
+  ctx.set_items_per_iteration(n_variants);
+  for (auto _ : ctx) {
+    for (auto& v : variants) {
+      untitled::visit(visitor, v);
+    }
+    untitled::bench::do_not_optimize(sum);
+  }
+}
+
+template <size_t N>
+void visit_std_variant(untitled::bench::context& ctx) {
+  static constexpr size_t n_variants = 1'024;
+
+  auto variants = make_variant<std::variant, std::make_index_sequence<N>>::random(n_variants);
+
+  long sum     = 0;
+  auto visitor = [&sum](auto& a) { sum += a.value; };
+
+  ctx.set_items_per_iteration(n_variants);
+  for (auto _ : ctx) {
+    for (auto& v : variants) {
+      std::visit(visitor, v);
+    }
+    untitled::bench::do_not_optimize(sum);
+  }
+}
+
+UNTITLED_BENCHMARK("variant/visit/alternatives:1", visit_untitled_variant<1>);
+UNTITLED_BENCHMARK("variant/visit/alternatives:2", visit_untitled_variant<2>);
+UNTITLED_BENCHMARK("variant/visit/alternatives:4", visit_untitled_variant<4>);
+UNTITLED_BENCHMARK("variant/visit/alternatives:8", visit_untitled_variant<8>);
+UNTITLED_BENCHMARK("variant/visit/alternatives:16", visit_untitled_variant<16>);
+UNTITLED_BENCHMARK("variant/visit/alternatives:32", visit_untitled_variant<32>);
+
+// n.b. std::variant is used as baseline
+UNTITLED_BENCHMARK("variant/std_visit/alternatives:1", visit_std_variant<1>);
+UNTITLED_BENCHMARK("variant/std_visit/alternatives:2", visit_std_variant<2>);
+UNTITLED_BENCHMARK("variant/std_visit/alternatives:4", visit_std_variant<4>);
+UNTITLED_BENCHMARK("variant/std_visit/alternatives:8", visit_std_variant<8>);
+UNTITLED_BENCHMARK("variant/std_visit/alternatives:16", visit_std_variant<16>);
+UNTITLED_BENCHMARK("variant/std_visit/alternatives:32", visit_std_variant<32>);
+
+} // namespace
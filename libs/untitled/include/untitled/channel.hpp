@@ -0,0 +1,230 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#ifndef UNTITLED_CHANNEL_HPP
+#define UNTITLED_CHANNEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace untitled {
+
+namespace detail {
+
+// n.b. std::hardware_destructive_interference_size is not used, as it is not ABI stable
+constexpr size_t cache_line_size = 64;
+
+} // namespace detail
+
+// Bounded single-producer/single-consumer channel, implemented as a ring buffer.
+//
+// All try_* and *_n operations are wait-free. The head (consumer) and tail (producer) indices live in separate
+// cache lines, and each side keeps a cached copy of the other side's index, so that the shared cache lines are
+// only touched when the channel appears to be full (producer) or empty (consumer).
+//
+// When Blocking, push/pop additionally wait (spinning briefly, then sleeping) for room/data to become available.
+// This costs every operation a fence, in order to detect sleeping peers, hence the non-blocking default.
+//
+// n.b. exactly one thread may push, and exactly one thread may pop, at any given time
+
+template <typename T, bool Blocking = false>
+class spsc_channel {
+public:
+  using value_type = T;
+
+  explicit spsc_channel(size_t capacity) : capacity_{std::bit_ceil(std::max(capacity, size_t(2)))}, mask_{capacity_ - 1}, buffer_{new T[capacity_]} {}
+  spsc_channel(const spsc_channel&) = delete;
+  ~spsc_channel() = default;
+
+  spsc_channel& operator=(const spsc_channel&) = delete;
+
+  size_t capacity() const { return capacity_; }
+
+  // [producer]
+
+  bool try_push(T v) { return push_one(v); }
+
+  // Pushes up to n values (as many as fit), and returns the number of values pushed
+  template <typename InputIt>
+  size_t push_n(InputIt first, size_t n) {
+    size_t t = tail_.load(std::memory_order_relaxed);
+    if (capacity_ - (t - cached_head_) < n) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    size_t m = std::min(n, capacity_ - (t - cached_head_));
+    for (size_t i = 0; i < m; ++i, ++first) {
+      buffer_[(t + i) & mask_] = *first;
+    }
+    if (m > 0) {
+      tail_.store(t + m, std::memory_order_release);
+      wake();
+    }
+    return m;
+  }
+
+  // Waits for room, and returns false only if the channel was cancelled
+  bool push(T v)
+    requires Blocking
+  {
+    while (!push_one(v)) {
+      if (cancel_.load(std::memory_order_acquire)) {
+        return false;
+      }
+      wait_until([this] { return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire) < capacity_; });
+    }
+    return true;
+  }
+
+  // [consumer]
+
+  bool try_pop(T& v) {
+    size_t h = head_.load(std::memory_order_relaxed);
+    if (h == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (h == cached_tail_) {
+        return false;
+      }
+    }
+    v = std::move(buffer_[h & mask_]);
+    head_.store(h + 1, std::memory_order_release);
+    wake();
+    return true;
+  }
+
+  // Pops up to n values (as many as available), and returns the number of values popped
+  template <typename OutputIt>
+  size_t pop_n(OutputIt out, size_t n) {
+    size_t h = head_.load(std::memory_order_relaxed);
+    if (cached_tail_ - h < n) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    size_t m = std::min(n, cached_tail_ - h);
+    for (size_t i = 0; i < m; ++i, ++out) {
+      *out = std::move(buffer_[(h + i) & mask_]);
+    }
+    if (m > 0) {
+      head_.store(h + m, std::memory_order_release);
+      wake();
+    }
+    return m;
+  }
+
+  // Waits for data, and returns false only if the channel was cancelled (and all data consumed)
+  bool pop(T& v)
+    requires Blocking
+  {
+    while (!try_pop(v)) {
+      if (cancel_.load(std::memory_order_acquire)) {
+        return try_pop(v);
+      }
+      wait_until([this] { return has_data(); });
+    }
+    return true;
+  }
+
+  // Waits for data, and then pops up to n values; returns 0 only if the channel was cancelled (and all data consumed)
+  template <typename OutputIt>
+  size_t wait_pop_n(OutputIt out, size_t n)
+    requires Blocking
+  {
+    while (true) {
+      if (size_t m = pop_n(out, n); m > 0) {
+        return m;
+      }
+      if (cancel_.load(std::memory_order_acquire)) {
+        return pop_n(out, n);
+      }
+      wait_until([this] { return has_data(); });
+    }
+  }
+
+  // [either]
+
+  // Releases all waiting threads, and prevents further waiting
+  void cancel()
+    requires Blocking
+  {
+    cancel_.store(true, std::memory_order_release);
+    wake();
+  }
+
+private:
+  // n.b. v is only moved from when successfully pushed
+  bool push_one(T& v) {
+    size_t t = tail_.load(std::memory_order_relaxed);
+    if (t - cached_head_ == capacity_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (t - cached_head_ == capacity_) {
+        return false;
+      }
+    }
+    buffer_[t & mask_] = std::move(v);
+    tail_.store(t + 1, std::memory_order_release);
+    wake();
+    return true;
+  }
+
+  bool has_data() const { return tail_.load(std::memory_order_acquire) != head_.load(std::memory_order_relaxed); }
+
+  template <typename Predicate>
+  void wait_until(Predicate&& ready) {
+    static constexpr int spin_count = 128;
+    for (int i = 0; i < spin_count; ++i) {
+      if (ready() || cancel_.load(std::memory_order_relaxed)) {
+        return;
+      }
+    }
+
+    // n.b. the fences (here and in wake) guarantee that either the peer sees this thread waiting, or this thread
+    //      sees the peer's update -- so a wake up is never missed
+    uint32_t epoch = epoch_.load(std::memory_order_acquire);
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!ready() && !cancel_.load(std::memory_order_acquire)) {
+      epoch_.wait(epoch, std::memory_order_acquire);
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void wake() {
+    if constexpr (Blocking) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (waiters_.load(std::memory_order_relaxed) > 0) {
+        epoch_.fetch_add(1, std::memory_order_release);
+        epoch_.notify_all();
+      }
+    }
+  }
+
+  // n.b. read-only after construction
+  const size_t capacity_;
+  const size_t mask_;
+  const std::unique_ptr<T[]> buffer_;
+
+  // consumer side
+  alignas(detail::cache_line_size) std::atomic<size_t> head_{0};
+  size_t cached_tail_ = 0;
+
+  // producer side
+  alignas(detail::cache_line_size) std::atomic<size_t> tail_{0};
+  size_t cached_head_ = 0;
+
+  // blocking support
+  alignas(detail::cache_line_size) std::atomic<uint32_t> epoch_{0};
+  std::atomic<uint32_t> waiters_{0};
+  std::atomic<bool> cancel_{false};
+};
+
+} // namespace untitled
+
+#endif
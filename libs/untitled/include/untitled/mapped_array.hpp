@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#ifndef UNTITLED_MAPPED_ARRAY_HPP
+#define UNTITLED_MAPPED_ARRAY_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+#include <typeinfo>
+
+namespace untitled {
+
+// How the pages of a mapped array can be accessed
+//  - read_only: pages are shared with the page cache, and cannot be modified
+//  - copy_on_write: pages can be modified, but changes are private and never reach the file
+enum class map_mode { read_only, copy_on_write };
+
+// Hints to the kernel on how the pages of a mapped array will be accessed
+enum class map_advice { normal, sequential, random, will_need };
+
+struct map_options {
+  map_mode mode     = map_mode::read_only;
+  map_advice advice = map_advice::normal;
+  bool huge_pages   = false; // n.b. best effort, silently ignored when not supported
+};
+
+namespace detail {
+
+// The header stored at the beginning of a mapped array file.
+// The elements follow immediately after, and are thus aligned to (at least) 64 bytes.
+
+struct mapped_header {
+  static constexpr uint64_t magic_value   = 0x44454c5449544e55; // i.e. "UNTITLED", when stored as little endian
+  static constexpr uint32_t version_value = 1;
+
+  uint64_t magic        = magic_value;
+  uint32_t version      = version_value;
+  uint32_t element_size = 0;
+  uint64_t element_type = 0;
+  uint64_t count        = 0;
+  uint8_t reserved[32]  = {};
+};
+
+static_assert(sizeof(mapped_header) == 64);
+
+// Fingerprint identifying the type of elements, used to reject files holding a different type.
+// n.b. the fingerprint is only stable across binaries built with the same toolchain
+uint64_t type_fingerprint(const std::type_info& info, size_t size, size_t alignment);
+
+template <typename T>
+uint64_t type_fingerprint() {
+  return type_fingerprint(typeid(T), sizeof(T), alignof(T));
+}
+
+// RAII handle to a memory mapped array file (header included)
+
+class mapped_file {
+public:
+  mapped_file() = default;
+  mapped_file(const std::filesystem::path& path, uint32_t element_size, uint64_t element_type, const map_options& options);
+  mapped_file(const mapped_file&) = delete;
+  mapped_file(mapped_file&& other) noexcept;
+  ~mapped_file();
+
+  mapped_file& operator=(const mapped_file&) = delete;
+  mapped_file& operator=(mapped_file&& other) noexcept;
+
+  std::byte* data() const { return base_ ? static_cast<std::byte*>(base_) + sizeof(mapped_header) : nullptr; }
+  uint64_t count() const { return base_ ? static_cast<const mapped_header*>(base_)->count : 0; }
+  bool writable() const { return mode_ == map_mode::copy_on_write; }
+
+  void advise(map_advice advice, size_t offset, size_t length) const;
+
+private:
+  void* base_    = nullptr;
+  size_t length_ = 0;
+  map_mode mode_ = map_mode::read_only;
+};
+
+void write_mapped_file(const std::filesystem::path& path, uint32_t element_size, uint64_t element_type, const void* data, uint64_t count);
+
+} // namespace detail
+
+// A file-backed array, whose elements are memory mapped directly from disk.
+//
+// Opening is O(1), as no elements are read upfront: pages are loaded lazily by whichever thread first touches them.
+// The file is expected to have been created by mapped_array<T>::create, and is rejected (std::runtime_error) if
+// its header records a different element type.
+
+template <typename T>
+class mapped_array {
+public:
+  static_assert(std::is_trivially_copyable_v<T>, "mapped array elements must be trivially copyable");
+  static_assert(alignof(T) <= sizeof(detail::mapped_header), "mapped array elements cannot be over-aligned");
+
+  using value_type     = T;
+  using size_type      = size_t;
+  using iterator       = T*;
+  using const_iterator = const T*;
+
+  mapped_array() = default;
+
+  explicit mapped_array(const std::filesystem::path& path, const map_options& options = {})
+      : file_{path, sizeof(T), detail::type_fingerprint<T>(), options} {}
+
+  // Writes the values to a new file, atomically replacing any existing file (while keeping its existing mappings valid)
+  static void create(const std::filesystem::path& path, std::span<const T> values) {
+    detail::write_mapped_file(path, sizeof(T), detail::type_fingerprint<T>(), values.data(), values.size());
+  }
+
+  size_type size() const { return file_.count(); }
+  bool empty() const { return size() == 0; }
+  bool writable() const { return file_.writable(); }
+
+  const T* data() const { return reinterpret_cast<const T*>(file_.data()); }
+  const T& operator[](size_type i) const { return data()[i]; }
+
+  // n.b. only valid for copy_on_write mappings
+  T* mutable_data() {
+    assert(writable());
+    return reinterpret_cast<T*>(file_.data());
+  }
+
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + size(); }
+
+  operator std::span<const T>() const { return {data(), size()}; }
+
+  // Hint the access pattern for the elements in [first, first + count)
+  // n.b. the range is clamped to the array (in elements, before converting to bytes, so that it cannot overflow)
+  void advise(map_advice advice, size_type first, size_type count) const {
+    first = std::min(first, size());
+    count = std::min(count, size() - first);
+    file_.advise(advice, first * sizeof(T), count * sizeof(T));
+  }
+  void advise(map_advice advice) const { advise(advice, 0, size()); }
+
+private:
+  detail::mapped_file file_;
+};
+
+} // namespace untitled
+
+#endif
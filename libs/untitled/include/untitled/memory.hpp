@@ -0,0 +1,161 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#ifndef UNTITLED_MEMORY_HPP
+#define UNTITLED_MEMORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace untitled {
+
+// [arena], monotonic (bump pointer) memory resource
+//
+// Allocations are carved sequentially out of chunks obtained from the upstream resource, and individual
+// deallocations are no-ops. All memory is dropped at once, either by reset() (keeping the latest chunk for
+// reuse) or by release() (returning every chunk upstream). Not thread-safe: use one arena per request/thread.
+//
+// n.b. as such, an arena can only back a thread_pool when tasks are submitted from a single thread, and no delayed
+//      nor periodic tasks are used (as the timer thread allocates too); the workers only deallocate, which is a no-op
+
+class arena_resource : public std::pmr::memory_resource {
+public:
+  static constexpr size_t default_chunk_size = 64 * 1024;
+
+  explicit arena_resource(size_t initial_chunk_size = default_chunk_size, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : upstream_{upstream}, next_chunk_size_{initial_chunk_size} {}
+  arena_resource(const arena_resource&) = delete;
+  ~arena_resource() override { release(); }
+
+  arena_resource& operator=(const arena_resource&) = delete;
+
+  // Fast path, bypassing the virtual dispatch of std::pmr::memory_resource::allocate
+  void* allocate_bytes(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+    auto current = reinterpret_cast<uintptr_t>(current_);
+    auto aligned = (current + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    if (current_ && aligned + bytes <= reinterpret_cast<uintptr_t>(end_)) {
+      current_ = reinterpret_cast<std::byte*>(aligned + bytes);
+      return reinterpret_cast<void*>(aligned);
+    }
+    return allocate_from_new_chunk(bytes, alignment);
+  }
+
+  // Drops all allocations, but keeps the latest (and largest) chunk to serve further allocations
+  void reset();
+
+  // Drops all allocations, and returns all chunks to the upstream resource
+  void release();
+
+  std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+
+protected:
+  void* do_allocate(size_t bytes, size_t alignment) override { return allocate_bytes(bytes, alignment); }
+  void do_deallocate(void*, size_t, size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+  struct chunk {
+    chunk* previous;
+    size_t size; // n.b. includes this header
+  };
+
+  void* allocate_from_new_chunk(size_t bytes, size_t alignment);
+
+  std::pmr::memory_resource* upstream_;
+  size_t next_chunk_size_;
+  chunk* chunks_      = nullptr;
+  std::byte* current_ = nullptr;
+  std::byte* end_     = nullptr;
+};
+
+// [arena], std allocator backed by an arena_resource
+//
+// Equivalent to std::pmr::polymorphic_allocator<T>{&arena}, but without the virtual dispatch on each allocation.
+
+template <typename T>
+class arena_allocator {
+public:
+  using value_type = T;
+
+  arena_allocator(arena_resource& arena) noexcept : arena_{&arena} {}
+  template <typename U>
+  arena_allocator(const arena_allocator<U>& other) noexcept : arena_{other.resource()} {}
+
+  T* allocate(size_t n) {
+    if (n > size_t(-1) / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T*>(arena_->allocate_bytes(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T*, size_t) noexcept {}
+
+  arena_resource* resource() const noexcept { return arena_; }
+
+  template <typename U>
+  bool operator==(const arena_allocator<U>& other) const noexcept {
+    return arena_ == other.resource();
+  }
+
+private:
+  arena_resource* arena_;
+};
+
+// [pool], thread-local pool memory resource
+//
+// Small allocations (up to max_pooled_size bytes) are served from per-thread free lists, segregated by size class,
+// and thus never contend between threads. Blocks can be deallocated from any thread: they simply join the free
+// list of the deallocating thread, and surplus blocks are handed over (in batches) to a shared depot from where
+// other threads refill. Larger allocations are forwarded to the upstream resource (i.e. new/delete).
+//
+// n.b. a single process-wide instance exists, see thread_local_pool()
+
+class thread_local_pool_resource : public std::pmr::memory_resource {
+public:
+  static constexpr size_t max_pooled_size = 1024;
+
+  void* allocate_bytes(size_t bytes, size_t alignment = alignof(std::max_align_t));
+  void deallocate_bytes(void* p, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept;
+
+protected:
+  void* do_allocate(size_t bytes, size_t alignment) override { return allocate_bytes(bytes, alignment); }
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override { deallocate_bytes(p, bytes, alignment); }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+thread_local_pool_resource* thread_local_pool() noexcept;
+
+// [pool], std allocator backed by the thread-local pool
+
+template <typename T>
+class pool_allocator {
+public:
+  using value_type = T;
+
+  pool_allocator() noexcept = default;
+  template <typename U>
+  pool_allocator(const pool_allocator<U>&) noexcept {}
+
+  T* allocate(size_t n) {
+    if (n > size_t(-1) / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T*>(thread_local_pool()->allocate_bytes(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* p, size_t n) noexcept { thread_local_pool()->deallocate_bytes(p, n * sizeof(T), alignof(T)); }
+
+  template <typename U>
+  bool operator==(const pool_allocator<U>&) const noexcept {
+    return true;
+  }
+};
+
+} // namespace untitled
+
+#endif
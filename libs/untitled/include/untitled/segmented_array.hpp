@@ -0,0 +1,220 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#ifndef UNTITLED_SEGMENTED_ARRAY_HPP
+#define UNTITLED_SEGMENTED_ARRAY_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace untitled {
+
+// A growable array, supporting concurrent (lock-free) appends, whose elements never move.
+//
+// Elements are stored in segments of geometrically growing size: segment k holds (first_segment_size << k) elements,
+// so locating an element is a couple of bit operations and growing never copies nor relocates existing elements.
+// Each append reserves its slot with a single fetch-add, and a missing segment is allocated by whichever appender
+// needs it first (racing appenders discard their own allocation).
+//
+// n.b. appends are safe to run concurrently with each other and with accesses to other (fully appended) elements;
+//      as usual, reading an element appended by another thread requires synchronisation with that thread (e.g.
+//      joining it, or waiting for the thread_pool to finish), and the destructor assumes no appends are in flight.
+//      A reserved slot cannot be given back, so the element must be constructed in it without throwing: when
+//      constructing from the given arguments may throw, the element is constructed upfront (where throwing leaves
+//      the array unchanged) and then moved into the slot -- so only types that are nothrow constructible from the
+//      arguments, or nothrow move constructible, are supported. For the same reason, failing to allocate a segment
+//      while appending terminates; use reserve() to allocate the segments upfront, if that must be handled.
+
+template <typename T, typename Allocator = std::allocator<T>>
+class segmented_array {
+private:
+  using allocator_t = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+  using traits_t    = std::allocator_traits<allocator_t>;
+
+  template <typename V>
+  class basic_iterator;
+
+public:
+  static constexpr size_t first_segment_size = 32;
+  static constexpr size_t n_segments         = std::numeric_limits<size_t>::digits - std::bit_width(first_segment_size - 1);
+
+  using value_type     = T;
+  using size_type      = size_t;
+  using allocator_type = allocator_t;
+  using iterator       = basic_iterator<T>;
+  using const_iterator = basic_iterator<const T>;
+
+  segmented_array() : segmented_array(Allocator{}) {}
+  explicit segmented_array(const Allocator& allocator) : allocator_{allocator} {}
+  segmented_array(const segmented_array&) = delete;
+  ~segmented_array() {
+    size_t n = size();
+    for (size_t k = 0; k < n_segments; ++k) {
+      T* segment = segments_[k].load(std::memory_order_acquire);
+      if (!segment) {
+        continue;
+      }
+      size_t first = segment_start(k);
+      for (size_t i = first; i < n && i < first + segment_size(k); ++i) {
+        traits_t::destroy(allocator_, segment + (i - first));
+      }
+      traits_t::deallocate(allocator_, segment, segment_size(k));
+    }
+  }
+
+  segmented_array& operator=(const segmented_array&) = delete;
+
+  template <typename... Args>
+    requires(std::is_nothrow_constructible_v<T, Args&&...> || std::is_nothrow_move_constructible_v<T>)
+  T& emplace_back(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args&&...>) {
+    if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+      return append(std::forward<Args>(args)...);
+    }
+    else {
+      T value(std::forward<Args>(args)...);
+      return append(std::move(value));
+    }
+  }
+
+  T& push_back(const T& value)
+    requires(std::is_nothrow_copy_constructible_v<T> || std::is_nothrow_move_constructible_v<T>)
+  {
+    return emplace_back(value);
+  }
+  T& push_back(T&& value)
+    requires std::is_nothrow_move_constructible_v<T>
+  {
+    return emplace_back(std::move(value));
+  }
+
+  // Allocates (upfront) the segments required to hold, at least, n elements
+  void reserve(size_t n) {
+    for (size_t k = 0; k < n_segments && segment_start(k) < n; ++k) {
+      ensure_segment(k);
+    }
+  }
+
+  // n.b. includes the slots reserved by appends still in flight
+  size_type size() const { return size_.load(std::memory_order_acquire); }
+  bool empty() const { return size() == 0; }
+
+  T& operator[](size_t i) {
+    auto [k, j] = locate(i);
+    return segments_[k].load(std::memory_order_acquire)[j];
+  }
+  const T& operator[](size_t i) const {
+    auto [k, j] = locate(i);
+    return segments_[k].load(std::memory_order_acquire)[j];
+  }
+
+  iterator begin() { return {this, 0}; }
+  iterator end() { return {this, size()}; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, size()}; }
+
+  allocator_type get_allocator() const { return allocator_; }
+
+private:
+  static constexpr size_t segment_size(size_t k) { return first_segment_size << k; }
+  static constexpr size_t segment_start(size_t k) { return first_segment_size * ((size_t(1) << k) - 1); }
+
+  // Determines the segment, and the offset within that segment, holding element i
+  static constexpr std::pair<size_t, size_t> locate(size_t i) {
+    size_t k = std::bit_width(i / first_segment_size + 1) - 1;
+    return {k, i - segment_start(k)};
+  }
+
+  // n.b. noexcept, as the slot is reserved before its segment is allocated
+  template <typename... Args>
+  T& append(Args&&... args) noexcept {
+    size_t i    = size_.fetch_add(1, std::memory_order_relaxed);
+    auto [k, j] = locate(i);
+    T* element  = ensure_segment(k) + j;
+    traits_t::construct(allocator_, element, std::forward<Args>(args)...);
+    return *element;
+  }
+
+  T* ensure_segment(size_t k) {
+    T* segment = segments_[k].load(std::memory_order_acquire);
+    if (segment) {
+      return segment;
+    }
+    T* allocated = traits_t::allocate(allocator_, segment_size(k));
+    if (segments_[k].compare_exchange_strong(segment, allocated, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      return allocated;
+    }
+    // Another appender allocated the segment first
+    traits_t::deallocate(allocator_, allocated, segment_size(k));
+    return segment;
+  }
+
+  template <typename V>
+  class basic_iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = std::remove_const_t<V>;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = V*;
+    using reference         = V&;
+    using owner_t           = std::conditional_t<std::is_const_v<V>, const segmented_array, segmented_array>;
+
+    basic_iterator() = default;
+    basic_iterator(owner_t* owner, size_t i) : owner_{owner}, i_{i} {}
+
+    reference operator*() const { return (*owner_)[i_]; }
+    pointer operator->() const { return &(*owner_)[i_]; }
+    reference operator[](difference_type n) const { return (*owner_)[i_ + n]; }
+
+    basic_iterator& operator++() {
+      ++i_;
+      return *this;
+    }
+    basic_iterator operator++(int) { return {owner_, i_++}; }
+    basic_iterator& operator--() {
+      --i_;
+      return *this;
+    }
+    basic_iterator operator--(int) { return {owner_, i_--}; }
+    basic_iterator& operator+=(difference_type n) {
+      i_ += n;
+      return *this;
+    }
+    basic_iterator& operator-=(difference_type n) {
+      i_ -= n;
+      return *this;
+    }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+    friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+    friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) { return difference_type(a.i_) - difference_type(b.i_); }
+
+    friend bool operator==(const basic_iterator& a, const basic_iterator& b) { return a.i_ == b.i_; }
+    friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) { return a.i_ <=> b.i_; }
+
+  private:
+    owner_t* owner_ = nullptr;
+    size_t i_       = 0;
+  };
+
+  [[no_unique_address]] allocator_t allocator_;
+  std::array<std::atomic<T*>, n_segments> segments_{};
+  alignas(64) std::atomic<size_t> size_{0}; // n.b. kept apart from the (mostly read) segments, to avoid false sharing
+};
+
+} // namespace untitled
+
+#endif
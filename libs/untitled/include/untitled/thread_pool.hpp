@@ -9,30 +9,220 @@
 #ifndef UNTITLED_THREAD_POOL_H
 #define UNTITLED_THREAD_POOL_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <ranges>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "untitled/timer_wheel.hpp"
 
 namespace untitled {
 
-template <typename T>
+// Type-erased callable, akin to std::function<void()>, whose target is stored inline when small enough and is
+// otherwise allocated from a memory resource (e.g. an arena, or the thread-local pool) rather than by new/delete.
+//
+// n.b. a copy allocates from the same memory resource as the original
+
+class task {
+public:
+  static constexpr size_t inline_size = 2 * sizeof(void*);
+
+  task() noexcept = default;
+  task(std::nullptr_t) noexcept {}
+  template <typename F>
+    requires(!std::is_same_v<std::decay_t<F>, task> && std::is_invocable_v<std::decay_t<F>&>)
+  task(F&& f) : task(std::allocator_arg, std::pmr::get_default_resource(), std::forward<F>(f)) {}
+  template <typename F>
+    requires(!std::is_same_v<std::decay_t<F>, task> && std::is_invocable_v<std::decay_t<F>&>)
+  task(std::allocator_arg_t, std::pmr::memory_resource* resource, F&& f) : resource_{resource} {
+    model<std::decay_t<F>>::create(*this, std::forward<F>(f));
+    ops_ = &model<std::decay_t<F>>::ops;
+  }
+  task(const task& other) : resource_{other.resource_} {
+    if (other.ops_) {
+      other.ops_->copy(other, *this);
+      ops_ = other.ops_;
+    }
+  }
+  task(task&& other) noexcept : resource_{other.resource_} { take(other); }
+  ~task() { reset(); }
+
+  task& operator=(const task& other) { return *this = task{other}; }
+  task& operator=(task&& other) noexcept {
+    if (this != &other) {
+      reset();
+      resource_ = other.resource_;
+      take(other);
+    }
+    return *this;
+  }
+  task& operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+
+  explicit operator bool() const noexcept { return ops_ != nullptr; }
+  void operator()() const { ops_->invoke(*this); }
+
+  std::pmr::memory_resource* resource() const noexcept { return resource_; }
+
+private:
+  struct ops_t {
+    void (*invoke)(const task&);
+    void (*copy)(const task& from, task& to);
+    void (*move)(task& from, task& to) noexcept; // n.b. also destroys the target of from
+    void (*destroy)(task&) noexcept;
+  };
+
+  template <typename F>
+  struct model {
+    static constexpr bool is_inline = sizeof(F) <= inline_size && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+    static F* target(const task& t) {
+      if constexpr (is_inline) {
+        return std::launder(reinterpret_cast<F*>(const_cast<std::byte*>(t.storage_.buffer)));
+      }
+      else {
+        return static_cast<F*>(t.storage_.heap);
+      }
+    }
+
+    template <typename... Args>
+    static void create(task& t, Args&&... args) {
+      if constexpr (is_inline) {
+        ::new (static_cast<void*>(t.storage_.buffer)) F(std::forward<Args>(args)...);
+      }
+      else {
+        void* p = t.resource_->allocate(sizeof(F), alignof(F));
+        try {
+          t.storage_.heap = ::new (p) F(std::forward<Args>(args)...);
+        }
+        catch (...) {
+          t.resource_->deallocate(p, sizeof(F), alignof(F));
+          throw;
+        }
+      }
+    }
+
+    static void invoke(const task& t) { std::invoke(*target(t)); }
+    static void copy(const task& from, task& to) { create(to, *target(from)); }
+    static void move(task& from, task& to) noexcept {
+      if constexpr (is_inline) {
+        create(to, std::move(*target(from)));
+        target(from)->~F();
+      }
+      else {
+        to.storage_.heap = from.storage_.heap;
+      }
+    }
+    static void destroy(task& t) noexcept {
+      F* f = target(t);
+      f->~F();
+      if constexpr (!is_inline) {
+        t.resource_->deallocate(f, sizeof(F), alignof(F));
+      }
+    }
+
+    static constexpr ops_t ops{&invoke, &copy, &move, &destroy};
+  };
+
+  void take(task& other) noexcept {
+    if (other.ops_) {
+      other.ops_->move(other, *this);
+      ops_ = std::exchange(other.ops_, nullptr);
+    }
+  }
+
+  void reset() noexcept {
+    if (ops_) {
+      std::exchange(ops_, nullptr)->destroy(*this);
+    }
+  }
+
+  union storage {
+    alignas(std::max_align_t) std::byte buffer[inline_size];
+    void* heap;
+  };
+
+  storage storage_;
+  const ops_t* ops_                    = nullptr;
+  std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+};
+
+template <typename T, typename Allocator = std::allocator<T>>
 struct thread_safe_queue {
 public:
   thread_safe_queue() : q_{}, m_{}, c_{} {}
+  explicit thread_safe_queue(const Allocator& allocator) : q_{allocator}, m_{}, c_{} {}
   ~thread_safe_queue() {}
 
   void push(T v) {
     std::lock_guard<std::mutex> lock(m_);
 
-    q_.push(v);
+    q_.push_back(std::move(v));
     c_.notify_one();
   }
 
+  // Pushes all values in [first, last) under a single lock, and wakes only as many waiting threads as values pushed
+  // n.b. if pushing throws, the values already pushed are removed again (so either all values are pushed, or none)
+  template <typename InputIt>
+  void push(InputIt first, InputIt last) {
+    size_t n_wake = 0;
+    bool wake_all = false;
+    {
+      std::lock_guard<std::mutex> lock(m_);
+
+      size_t n = 0;
+      try {
+        for (; first != last; ++first, ++n) {
+          q_.push_back(*first);
+        }
+      }
+      catch (...) {
+        // n.b. no waiting thread can have seen the values, as the lock is still held
+        for (; n > 0; --n) {
+          q_.pop_back();
+        }
+        throw;
+      }
+      n_wake   = std::min(n, waiting_);
+      wake_all = n_wake > 0 && n_wake == waiting_;
+    }
+
+    // n.b. notifying after unlocking, so that woken threads do not immediately block on the mutex
+    if (wake_all) {
+      c_.notify_all();
+    }
+    else {
+      for (size_t i = 0; i < n_wake; ++i) {
+        c_.notify_one();
+      }
+    }
+  }
+
   bool pop(T& v, bool wait = true) {
     std::unique_lock<std::mutex> lock(m_);
 
     if (wait) {
+      ++waiting_;
       c_.wait(lock, [this] { return !q_.empty() || cancel_; });
+      --waiting_;
     }
     else if (q_.empty()) {
       return false;
@@ -43,8 +233,8 @@ public:
       return false;
     }
 
-    v = q_.front();
-    q_.pop();
+    v = std::move(q_.front());
+    q_.pop_front();
     return true;
   }
 
@@ -62,17 +252,22 @@ public:
   }
 
 private:
-  std::queue<T> q_;
+  std::deque<T, Allocator> q_;
   mutable std::mutex m_;
   std::condition_variable c_;
-  bool cancel_ = false;
+  size_t waiting_ = 0; // n.b. number of threads waiting in pop
+  bool cancel_    = false;
 };
 
 class thread_pool {
 public:
-  using task_t = std::function<void()>;
+  using task_t = task;
 
-  explicit thread_pool(size_t num_threads = std::thread::hardware_concurrency()) {
+  // n.b. the memory resource backs both the queue of pending tasks and the tasks themselves (when not stored inline),
+  //      and is used from the submitting, timer and worker threads -- so it must be thread-safe (e.g. thread_local_pool()),
+  //      although an arena_resource can be used under the conditions documented there
+  explicit thread_pool(size_t num_threads = std::thread::hardware_concurrency(), std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : resource_{resource}, q_{std::pmr::polymorphic_allocator<task_t>{resource}} {
     for (size_t i = 0; i < num_threads; ++i) {
       t_.emplace_back([i, this] {
         while (true) {
@@ -93,7 +288,17 @@ public:
 
   size_t size() const { return t_.size(); }
 
+  // n.b. pending timers are dropped, while already submitted tasks are still executed
   void stop() {
+    {
+      std::lock_guard<std::mutex> lock(timer_m_);
+      timer_cancel_ = true;
+      timer_c_.notify_one();
+    }
+    if (timer_t_.joinable()) {
+      timer_t_.join();
+    }
+
     q_.cancel();
     for (auto& t : t_) {
       if (t.joinable()) {
@@ -102,11 +307,197 @@ public:
     }
   }
 
-  void submit(task_t task) { q_.push(task); }
+  template <typename F>
+  void submit(F&& f) {
+    q_.push(make_task(std::forward<F>(f)));
+  }
+
+  // Submits all tasks (or callables) in [first, last), at the cost of a single enqueue
+  // n.b. callables are turned into tasks (allocated from the pool's memory resource) as they are enqueued
+  template <typename InputIt>
+  void submit_bulk(InputIt first, InputIt last) {
+    auto tasks = std::ranges::subrange(first, last) | std::views::transform([this](auto&& f) { return make_task(std::forward<decltype(f)>(f)); });
+    q_.push(tasks.begin(), tasks.end());
+  }
+
+  // Submits n tasks, each calling f(i) for i in [0, n), at the cost of a single enqueue
+  template <typename F>
+  void submit_n(size_t n, F f) {
+    if (n == 0) {
+      return;
+    }
+
+    // n.b. f is held once, and freed by the last task to run, so that each task only carries a pointer and an index
+    //      (and thus fits the small buffer of task_t, requiring no allocation of its own)
+    std::pmr::polymorphic_allocator<> allocator{resource_};
+    auto* shared = allocator.new_object<fan_out<F>>(std::move(f), n, resource_);
+    try {
+      // n.b. the tasks are generated as they are enqueued, rather than collected upfront
+      auto tasks = std::views::iota(size_t(0), n) | std::views::transform([this, shared](size_t i) { return make_task([shared, i]() { shared->run(i); }); });
+      q_.push(tasks.begin(), tasks.end());
+    }
+    catch (...) {
+      // n.b. no task was enqueued
+      allocator.delete_object(shared);
+      throw;
+    }
+  }
+
+  // [timers]
+  //
+  // Delayed and periodic tasks are held in a timer wheel, serviced by a single (lazily started) timer thread, which
+  // submits each task to the pool once due -- so no worker is ever blocked waiting. Timers have a resolution of
+  // timer_resolution, and are cancelled in O(1).
+
+  static constexpr std::chrono::milliseconds timer_resolution{1};
+
+  // Submits the task, once the delay elapses
+  template <typename Rep, typename Period, typename F>
+  timer_id submit_after(std::chrono::duration<Rep, Period> delay, F&& f) {
+    return schedule(std::chrono::duration_cast<clock_t::duration>(delay), clock_t::duration::zero(), make_task(std::forward<F>(f)));
+  }
+
+  // Submits the task every period (the first time, after one period elapses), until cancelled
+  template <typename Rep, typename Period, typename F>
+  timer_id submit_every(std::chrono::duration<Rep, Period> period, F&& f) {
+    auto p = std::chrono::duration_cast<clock_t::duration>(period);
+    return schedule(p, std::max(p, clock_t::duration{1}), make_task(std::forward<F>(f)));
+  }
+
+  // Cancels a delayed/periodic task, returning false if it was no longer pending
+  // n.b. an occurrence already submitted to the pool is not affected
+  bool cancel(timer_id id) {
+    std::lock_guard<std::mutex> lock(timer_m_);
+    return wheel_.cancel(id);
+  }
 
 private:
+  template <typename F>
+  struct fan_out {
+    fan_out(F function, size_t n, std::pmr::memory_resource* r) : f{std::move(function)}, remaining{n}, resource{r} {}
+
+    const F f;
+    std::atomic<size_t> remaining;
+    std::pmr::memory_resource* resource;
+
+    void run(size_t i) {
+      struct release {
+        fan_out* self;
+        ~release() {
+          if (self->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::pmr::polymorphic_allocator<>{self->resource}.delete_object(self);
+          }
+        }
+      } guard{this};
+      f(i);
+    }
+  };
+
+  struct timer_entry {
+    task_t task;
+    uint64_t period; // n.b. in ticks, and zero for one-off timers
+  };
+
+  using clock_t = std::chrono::steady_clock;
+  using tick_t  = timer_wheel<timer_entry>::tick_t;
+
+  // n.b. callables (other than tasks) are turned into tasks allocated from the pool's memory resource
+  template <typename F>
+  task_t make_task(F&& f) const {
+    if constexpr (std::is_same_v<std::decay_t<F>, task_t>) {
+      return std::forward<F>(f);
+    }
+    else {
+      return task_t{std::allocator_arg, resource_, std::forward<F>(f)};
+    }
+  }
+
+  // n.b. rounds up
+  static tick_t to_ticks(clock_t::duration d) { return d <= clock_t::duration::zero() ? 0 : static_cast<tick_t>((d + timer_resolution - clock_t::duration{1}) / timer_resolution); }
+  tick_t current_tick() const { return static_cast<tick_t>((clock_t::now() - timer_epoch_) / timer_resolution); }
+
+  timer_id schedule(clock_t::duration delay, clock_t::duration period, task_t task) {
+    std::lock_guard<std::mutex> lock(timer_m_);
+    if (!timer_t_.joinable() && !timer_cancel_) {
+      timer_t_ = std::thread([this] { service_timers(); });
+    }
+
+    // n.b. rounding up from the current time (rather than adding to the current, rounded down, tick), so that tasks never run early
+    auto elapsed = clock_t::now() - timer_epoch_;
+    auto expiry  = std::max(to_ticks(elapsed + delay), static_cast<tick_t>(elapsed / timer_resolution) + 1);
+    auto id     = wheel_.schedule(expiry, timer_entry{std::move(task), to_ticks(period)});
+
+    // n.b. the timer thread only needs waking if the new timer is due before its planned wake up
+    if (expiry < timer_wake_) {
+      timer_c_.notify_one();
+    }
+    return id;
+  }
+
+  void service_timers() {
+    std::vector<task_t> due;
+
+    std::unique_lock<std::mutex> lock(timer_m_);
+    while (!timer_cancel_) {
+      auto now = current_tick();
+      // n.b. nothing can be allowed to throw while advancing, as that would leave the wheel half advanced
+      wheel_.advance(now, [&due, now](tick_t expiry, timer_entry& entry) noexcept -> std::optional<tick_t> {
+        if (entry.period == 0) {
+          try {
+            due.push_back(std::move(entry.task));
+          }
+          catch (...) {
+            return now + 1; // n.b. the task is kept (as moving it never throws), and retried on the next tick
+          }
+          return std::nullopt;
+        }
+        try {
+          due.push_back(entry.task);
+        }
+        catch (...) {
+          // n.b. the occurrence is skipped, while the timer is kept for the following ones
+        }
+        // n.b. fixed rate, but occurrences missed while overdue are skipped (rather than submitted in a burst)
+        return expiry + entry.period * ((now - expiry) / entry.period + 1);
+      });
+
+      if (!due.empty()) {
+        lock.unlock();
+        try {
+          q_.push(std::make_move_iterator(due.begin()), std::make_move_iterator(due.end()));
+        }
+        catch (...) {
+          // n.b. the due occurrences are dropped (as they are consumed even when enqueuing fails), but timers keep
+          //      being serviced, rather than the exception terminating the timer thread
+        }
+        due.clear();
+        lock.lock();
+        continue; // n.b. time has passed, and timers might have changed, while unlocked
+      }
+
+      auto next   = wheel_.next_tick();
+      timer_wake_ = next ? *next : tick_t(-1);
+      if (next) {
+        timer_c_.wait_until(lock, timer_epoch_ + *next * timer_resolution);
+      }
+      else {
+        timer_c_.wait(lock);
+      }
+      timer_wake_ = 0;
+    }
+  }
+
+  std::pmr::memory_resource* resource_;
   std::vector<std::thread> t_;
-  thread_safe_queue<task_t> q_;
+  thread_safe_queue<task_t, std::pmr::polymorphic_allocator<task_t>> q_;
+
+  std::thread timer_t_;
+  std::mutex timer_m_;
+  std::condition_variable timer_c_;
+  timer_wheel<timer_entry> wheel_;
+  const clock_t::time_point timer_epoch_ = clock_t::now();
+  tick_t timer_wake_                     = 0; // n.b. the tick at which the (waiting) timer thread wakes up
+  bool timer_cancel_                     = false;
 };
 
 template <typename T>
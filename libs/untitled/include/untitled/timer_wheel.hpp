@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#ifndef UNTITLED_TIMER_WHEEL_HPP
+#define UNTITLED_TIMER_WHEEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace untitled {
+
+// Identifies a timer, in order to cancel it
+// n.b. the generation ensures that a stale identifier never cancels a (reused) timer slot
+
+struct timer_id {
+  uint32_t index      = uint32_t(-1);
+  uint32_t generation = 0;
+
+  friend bool operator==(const timer_id&, const timer_id&) = default;
+};
+
+// Hierarchical timer wheel, holding timers that carry a payload of type T and expire at a given tick.
+//
+// The wheel has n_levels levels of slots_per_level slots each; level L spans (slots_per_level^(L+1)) ticks, with
+// each of its slots covering (slots_per_level^L) ticks. A timer is placed in the level corresponding to the most
+// significant group of bits in which its expiry differs from the current tick, and is moved (cascaded) to lower
+// levels as time advances. Scheduling and cancelling are O(1), and advancing costs O(1) per expired timer (plus at
+// most n_levels cascades per timer). Empty stretches of time are skipped, using a bitmap of occupied slots.
+//
+// n.b. not thread-safe
+
+template <typename T>
+class timer_wheel {
+public:
+  using tick_t = uint64_t;
+
+  static constexpr size_t bits_per_level  = 6;
+  static constexpr size_t slots_per_level = size_t(1) << bits_per_level;
+  static constexpr size_t n_levels        = 6;
+
+  explicit timer_wheel(tick_t now = 0) : current_{now} { slots_.fill(none); }
+
+  tick_t now() const { return current_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Schedules a timer to expire at the given tick (n.b. a tick in the past expires on the next advance)
+  timer_id schedule(tick_t expiry, T payload) {
+    uint32_t i;
+    if (free_ != none) {
+      i     = free_;
+      free_ = nodes_[i].next;
+    }
+    else {
+      i = static_cast<uint32_t>(nodes_.size());
+      nodes_.emplace_back();
+    }
+    nodes_[i].payload.emplace(std::move(payload));
+    link(i, std::max(expiry, current_ + 1));
+    ++size_;
+    return {i, nodes_[i].generation};
+  }
+
+  // Cancels a pending timer, returning false if the timer has already expired (or been cancelled)
+  bool cancel(timer_id id) {
+    if (id.index >= nodes_.size() || nodes_[id.index].generation != id.generation || !nodes_[id.index].payload) {
+      return false;
+    }
+    unlink(id.index);
+    release(id.index);
+    return true;
+  }
+
+  // The tick at which the wheel next needs to be advanced, if any timer is pending.
+  // n.b. this can precede the earliest expiry, as timers are cascaded between levels at slot boundaries
+  std::optional<tick_t> next_tick() const {
+    std::optional<tick_t> next;
+    for (size_t level = 0; level < n_levels; ++level) {
+      if (occupied_[level] == 0) {
+        continue;
+      }
+      size_t shift   = level * bits_per_level;
+      size_t current = (current_ >> shift) & (slots_per_level - 1);
+      // Look for the first occupied slot after the current one, wrapping around the level
+      uint64_t ahead = current + 1 < slots_per_level ? occupied_[level] >> (current + 1) : 0;
+      tick_t base    = (current_ >> (shift + bits_per_level)) << (shift + bits_per_level);
+      tick_t tick;
+      if (ahead != 0) {
+        tick = base + (tick_t(current + 1 + std::countr_zero(ahead)) << shift);
+      }
+      else {
+        tick = base + (tick_t(1) << (shift + bits_per_level)) + (tick_t(std::countr_zero(occupied_[level])) << shift);
+      }
+      next = next ? std::min(*next, tick) : tick;
+    }
+    return next;
+  }
+
+  // Advances the wheel up to (and including) the given tick, calling on_expiry(expiry, payload) for each expired
+  // timer, in order of expiry. If on_expiry returns a tick, the timer is rescheduled (keeping its identifier).
+  // n.b. on_expiry must not schedule nor cancel timers on this wheel
+  template <typename F>
+  size_t advance(tick_t now, F&& on_expiry) {
+    size_t expired = 0;
+    for (auto next = next_tick(); next && *next <= now; next = next_tick()) {
+      current_ = *next;
+
+      // Cascade higher levels first, so that their timers can be further cascaded to (or expire from) lower levels
+      for (size_t level = n_levels - 1; level > 0; --level) {
+        size_t shift = level * bits_per_level;
+        if ((current_ & ((tick_t(1) << shift) - 1)) == 0) {
+          for (uint32_t i = detach(level, (current_ >> shift) & (slots_per_level - 1)); i != none;) {
+            uint32_t next_i = nodes_[i].next;
+            link(i, nodes_[i].expiry); // n.b. timers due now land in the level 0 slot, expired below
+            i = next_i;
+          }
+        }
+      }
+
+      for (uint32_t i = detach(0, current_ & (slots_per_level - 1)); i != none;) {
+        uint32_t next_i = nodes_[i].next;
+        ++expired;
+        std::optional<tick_t> reschedule = on_expiry(nodes_[i].expiry, *nodes_[i].payload);
+        if (reschedule) {
+          link(i, std::max(*reschedule, current_ + 1));
+        }
+        else {
+          release(i);
+        }
+        i = next_i;
+      }
+    }
+    current_ = std::max(current_, now);
+    return expired;
+  }
+
+private:
+  static constexpr uint32_t none = uint32_t(-1);
+
+  struct node {
+    tick_t expiry       = 0;
+    uint32_t prev       = none;
+    uint32_t next       = none; // n.b. also links the free list
+    uint32_t slot       = none;
+    uint32_t generation = 0;
+    std::optional<T> payload;
+  };
+
+  // n.b. the expiry must not precede the current tick
+  void link(uint32_t i, tick_t expiry) {
+    // The level is given by the most significant group of bits in which the expiry differs from the current tick
+    // (and timers beyond the range of the wheel are parked at the top level, to be relinked when cascaded)
+    size_t level = expiry == current_ ? 0 : (std::bit_width(expiry ^ current_) - 1) / bits_per_level;
+    level        = std::min(level, n_levels - 1);
+    size_t slot  = (expiry >> (level * bits_per_level)) & (slots_per_level - 1);
+
+    node& n  = nodes_[i];
+    n.expiry = expiry;
+    n.slot   = static_cast<uint32_t>(level * slots_per_level + slot);
+    n.prev   = none;
+    n.next   = slots_[n.slot];
+    if (n.next != none) {
+      nodes_[n.next].prev = i;
+    }
+    slots_[n.slot] = i;
+    occupied_[level] |= uint64_t(1) << slot;
+  }
+
+  void unlink(uint32_t i) {
+    node& n = nodes_[i];
+    if (n.prev != none) {
+      nodes_[n.prev].next = n.next;
+    }
+    else {
+      slots_[n.slot] = n.next;
+      if (n.next == none) {
+        occupied_[n.slot / slots_per_level] &= ~(uint64_t(1) << (n.slot % slots_per_level));
+      }
+    }
+    if (n.next != none) {
+      nodes_[n.next].prev = n.prev;
+    }
+  }
+
+  // Empties the given slot, returning the first of its (still linked) timers
+  uint32_t detach(size_t level, size_t slot) {
+    uint32_t s = static_cast<uint32_t>(level * slots_per_level + slot);
+    uint32_t i = slots_[s];
+    slots_[s]  = none;
+    occupied_[level] &= ~(uint64_t(1) << slot);
+    return i;
+  }
+
+  void release(uint32_t i) {
+    node& n = nodes_[i];
+    n.payload.reset();
+    ++n.generation;
+    n.slot = none;
+    n.prev = none;
+    n.next = free_;
+    free_  = i;
+    --size_;
+  }
+
+  tick_t current_;
+  size_t size_   = 0;
+  uint32_t free_ = none;
+  std::vector<node> nodes_;
+  std::array<uint32_t, n_levels * slots_per_level> slots_;
+  std::array<uint64_t, n_levels> occupied_{};
+};
+
+} // namespace untitled
+
+#endif
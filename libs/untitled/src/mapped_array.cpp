@@ -0,0 +1,214 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "untitled/mapped_array.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace untitled::detail {
+
+namespace {
+
+[[noreturn]] void throw_system_error(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+struct file_descriptor {
+  explicit file_descriptor(int fd) : fd_{fd} {}
+  ~file_descriptor() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+  int fd_;
+};
+
+// Writes all bytes, retrying on partial writes, and throws if the write fails
+void write_all(int fd, const void* data, size_t size, const std::filesystem::path& path) {
+  const auto* bytes = static_cast<const std::byte*>(data);
+  while (size > 0) {
+    ssize_t written = ::write(fd, bytes, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0) {
+      throw_system_error("unable to write mapped array file " + path.string());
+    }
+    if (written == 0) {
+      throw std::runtime_error("unable to write mapped array file " + path.string() + " (short write)");
+    }
+    bytes += written;
+    size -= static_cast<size_t>(written);
+  }
+}
+
+int to_madvise(map_advice advice) {
+  switch (advice) {
+    case map_advice::sequential:
+      return MADV_SEQUENTIAL;
+    case map_advice::random:
+      return MADV_RANDOM;
+    case map_advice::will_need:
+      return MADV_WILLNEED;
+    default:
+      return MADV_NORMAL;
+  }
+}
+
+} // namespace
+
+uint64_t type_fingerprint(const std::type_info& info, size_t size, size_t alignment) {
+  // FNV-1a, over the (mangled) type name followed by the size and alignment
+  uint64_t hash = 0xcbf29ce484222325;
+  auto mix      = [&hash](uint64_t byte) {
+    hash ^= byte;
+    hash *= 0x100000001b3;
+  };
+  for (char c : std::string_view{info.name()}) {
+    mix(static_cast<unsigned char>(c));
+  }
+  for (uint64_t value : {static_cast<uint64_t>(size), static_cast<uint64_t>(alignment)}) {
+    for (size_t i = 0; i < sizeof(value); ++i) {
+      mix((value >> (8 * i)) & 0xff);
+    }
+  }
+  return hash;
+}
+
+mapped_file::mapped_file(const std::filesystem::path& path, uint32_t element_size, uint64_t element_type, const map_options& options) : mode_{options.mode} {
+  file_descriptor fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (fd.fd_ < 0) {
+    throw_system_error("unable to open mapped array file " + path.string());
+  }
+
+  struct stat st {};
+  if (::fstat(fd.fd_, &st) != 0) {
+    throw_system_error("unable to stat mapped array file " + path.string());
+  }
+  if (static_cast<size_t>(st.st_size) < sizeof(mapped_header)) {
+    throw std::runtime_error("mapped array file " + path.string() + " is too small to hold a header");
+  }
+
+  length_   = static_cast<size_t>(st.st_size);
+  int prot  = options.mode == map_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+  int flags = options.mode == map_mode::read_only ? MAP_SHARED : MAP_PRIVATE;
+  base_     = ::mmap(nullptr, length_, prot, flags, fd.fd_, 0);
+  if (base_ == MAP_FAILED) {
+    base_ = nullptr;
+    throw_system_error("unable to map mapped array file " + path.string());
+  }
+  // n.b. the mapping remains valid after the file descriptor is closed
+
+  auto reject = [this, &path](const char* reason) {
+    ::munmap(base_, length_);
+    base_ = nullptr;
+    throw std::runtime_error("mapped array file " + path.string() + " " + reason);
+  };
+
+  const auto& header = *static_cast<const mapped_header*>(base_);
+  if (header.magic != mapped_header::magic_value || header.version != mapped_header::version_value) {
+    reject("has an invalid header");
+  }
+  if (header.element_size != element_size || header.element_type != element_type) {
+    reject("holds elements of a different type");
+  }
+  if (header.count > (length_ - sizeof(mapped_header)) / element_size) {
+    reject("is truncated");
+  }
+
+  if (options.huge_pages) {
+#ifdef MADV_HUGEPAGE
+    ::madvise(base_, length_, MADV_HUGEPAGE);
+#endif
+  }
+  if (options.advice != map_advice::normal) {
+    ::madvise(base_, length_, to_madvise(options.advice));
+  }
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+    : base_{std::exchange(other.base_, nullptr)}, length_{std::exchange(other.length_, 0)}, mode_{other.mode_} {}
+
+mapped_file::~mapped_file() {
+  if (base_) {
+    ::munmap(base_, length_);
+  }
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+  if (this != &other) {
+    if (base_) {
+      ::munmap(base_, length_);
+    }
+    base_   = std::exchange(other.base_, nullptr);
+    length_ = std::exchange(other.length_, 0);
+    mode_   = other.mode_;
+  }
+  return *this;
+}
+
+void mapped_file::advise(map_advice advice, size_t offset, size_t length) const {
+  if (!base_ || length == 0) {
+    return;
+  }
+  // madvise requires a page aligned address, so the range is widened to include the whole first page
+  static const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+
+  if (offset >= length_ - sizeof(mapped_header)) {
+    return; // n.b. the range lies entirely past the end of the file
+  }
+  size_t first = sizeof(mapped_header) + offset;
+  size_t last  = first + std::min(length, length_ - first);
+  first        = first - first % page_size;
+  ::madvise(static_cast<std::byte*>(base_) + first, last - first, to_madvise(advice));
+}
+
+void write_mapped_file(const std::filesystem::path& path, uint32_t element_size, uint64_t element_type, const void* data, uint64_t count) {
+  mapped_header header;
+  header.element_size = element_size;
+  header.element_type = element_type;
+  header.count        = count;
+
+  // The file is written aside, and then renamed over the target, so that existing mappings of the target (which
+  // would fault if the file were truncated under them) keep seeing the previous contents
+  std::string temporary = path.string() + ".XXXXXX";
+  file_descriptor fd{::mkstemp(temporary.data())};
+  if (fd.fd_ < 0) {
+    throw_system_error("unable to create mapped array file " + path.string());
+  }
+
+  try {
+    write_all(fd.fd_, &header, sizeof(header), path);
+    write_all(fd.fd_, data, count * element_size, path);
+    // n.b. mkstemp creates the file accessible by its owner only, so the permissions of the target are kept (if any)
+    struct stat st {};
+    mode_t mode = ::stat(path.c_str(), &st) == 0 ? st.st_mode & 07777 : 0644;
+    if (::fchmod(fd.fd_, mode) != 0 || ::fsync(fd.fd_) != 0) {
+      throw_system_error("unable to write mapped array file " + path.string());
+    }
+    std::filesystem::rename(temporary, path);
+  }
+  catch (...) {
+    ::unlink(temporary.c_str());
+    throw;
+  }
+}
+
+} // namespace untitled::detail
@@ -0,0 +1,232 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "untitled/memory.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace untitled {
+
+// [arena]
+
+void* arena_resource::allocate_from_new_chunk(size_t bytes, size_t alignment) {
+  size_t required = sizeof(chunk) + bytes + alignment;
+  size_t size     = std::max(next_chunk_size_, required);
+
+  auto* c = static_cast<chunk*>(upstream_->allocate(size, alignof(std::max_align_t)));
+  c->previous = chunks_;
+  c->size     = size;
+
+  chunks_          = c;
+  current_         = reinterpret_cast<std::byte*>(c) + sizeof(chunk);
+  end_             = reinterpret_cast<std::byte*>(c) + size;
+  next_chunk_size_ = size * 2; // n.b. geometric growth, keeps the number of chunks logarithmic
+
+  return allocate_bytes(bytes, alignment);
+}
+
+void arena_resource::reset() {
+  if (!chunks_) {
+    return;
+  }
+  // Only the latest chunk is kept, as it is the largest
+  for (chunk* c = chunks_->previous; c;) {
+    chunk* previous = c->previous;
+    upstream_->deallocate(c, c->size, alignof(std::max_align_t));
+    c = previous;
+  }
+  chunks_->previous = nullptr;
+  current_          = reinterpret_cast<std::byte*>(chunks_) + sizeof(chunk);
+}
+
+void arena_resource::release() {
+  for (chunk* c = chunks_; c;) {
+    chunk* previous = c->previous;
+    upstream_->deallocate(c, c->size, alignof(std::max_align_t));
+    c = previous;
+  }
+  chunks_  = nullptr;
+  current_ = nullptr;
+  end_     = nullptr;
+}
+
+// [pool]
+
+namespace {
+
+constexpr size_t min_block_size      = 16;
+constexpr size_t max_block_alignment = 64;
+constexpr size_t n_size_classes      = std::bit_width(thread_local_pool_resource::max_pooled_size / min_block_size);
+constexpr size_t chunk_size          = 64 * 1024;
+constexpr size_t batch_size          = 64; // n.b. number of blocks moved at once between a thread and the depot
+
+struct block {
+  block* next;
+};
+
+struct batch {
+  block* head  = nullptr;
+  size_t count = 0;
+};
+
+// Shared reserve of free blocks, exchanged in batches with the per-thread caches
+struct depot {
+  std::mutex m;
+  std::vector<batch> batches[n_size_classes];
+
+  void put(size_t c, batch b) {
+    std::lock_guard<std::mutex> lock(m);
+    batches[c].push_back(b);
+  }
+
+  bool take(size_t c, batch& b) {
+    std::lock_guard<std::mutex> lock(m);
+    if (batches[c].empty()) {
+      return false;
+    }
+    b = batches[c].back();
+    batches[c].pop_back();
+    return true;
+  }
+};
+
+depot& the_depot() {
+  // n.b. intentionally leaked, as threads might still return blocks while static objects are being destroyed
+  static depot* d = new depot;
+  return *d;
+}
+
+size_t size_of_class(size_t c) {
+  return min_block_size << c;
+}
+
+// n.b. trivially destructible, and thus still accessible after the thread's cache has been destroyed
+thread_local bool cache_torn_down = false;
+
+struct thread_cache {
+  batch lists[n_size_classes];
+
+  ~thread_cache() {
+    for (size_t c = 0; c < n_size_classes; ++c) {
+      if (lists[c].count > 0) {
+        the_depot().put(c, lists[c]);
+      }
+    }
+    cache_torn_down = true;
+  }
+
+  void* pop(size_t c) {
+    batch& list = lists[c];
+    if (!list.head && !the_depot().take(c, list)) {
+      refill(c);
+    }
+    block* b  = list.head;
+    list.head = b->next;
+    --list.count;
+    return b;
+  }
+
+  void push(size_t c, void* p) {
+    batch& list = lists[c];
+    auto* b     = static_cast<block*>(p);
+    b->next     = list.head;
+    list.head   = b;
+    ++list.count;
+
+    if (list.count >= 2 * batch_size) {
+      // Hand over surplus blocks, so that memory freed by consumer threads flows back to producer threads
+      batch surplus{list.head, batch_size};
+      block* last = list.head;
+      for (size_t i = 1; i < batch_size; ++i) {
+        last = last->next;
+      }
+      list.head = last->next;
+      list.count -= batch_size;
+      last->next = nullptr;
+      the_depot().put(c, surplus);
+    }
+  }
+
+  void refill(size_t c) {
+    // n.b. chunks are never returned upstream, as their blocks may be spread across all threads
+    auto* memory = static_cast<std::byte*>(::operator new(chunk_size, std::align_val_t{max_block_alignment}));
+    size_t size  = size_of_class(c);
+    batch& list  = lists[c];
+    for (size_t offset = chunk_size; offset >= size; offset -= size) {
+      auto* b   = reinterpret_cast<block*>(memory + offset - size);
+      b->next   = list.head;
+      list.head = b;
+      ++list.count;
+    }
+  }
+};
+
+thread_local thread_cache cache;
+
+// Serves allocations once the thread's cache has been destroyed (e.g. by objects with static storage duration, as
+// the main thread's thread-local objects are destroyed first), going straight to the depot
+void* pop_without_cache(size_t c) {
+  batch b;
+  if (!the_depot().take(c, b)) {
+    return ::operator new(size_of_class(c), std::align_val_t{max_block_alignment});
+  }
+  block* head = b.head;
+  if (b.count > 1) {
+    the_depot().put(c, batch{head->next, b.count - 1});
+  }
+  return head;
+}
+
+void push_without_cache(size_t c, void* p) {
+  auto* b = static_cast<block*>(p);
+  b->next = nullptr;
+  the_depot().put(c, batch{b, 1});
+}
+
+// Determines the size class serving the allocation, or n_size_classes if the allocation is not pooled
+size_t class_of(size_t bytes, size_t alignment) {
+  size_t size = std::bit_ceil(std::max({bytes, alignment, min_block_size}));
+  if (size > thread_local_pool_resource::max_pooled_size || alignment > max_block_alignment) {
+    return n_size_classes;
+  }
+  return std::bit_width(size / min_block_size) - 1;
+}
+
+} // namespace
+
+void* thread_local_pool_resource::allocate_bytes(size_t bytes, size_t alignment) {
+  size_t c = class_of(bytes, alignment);
+  if (c == n_size_classes) {
+    return ::operator new(bytes, std::align_val_t{alignment});
+  }
+  return cache_torn_down ? pop_without_cache(c) : cache.pop(c);
+}
+
+void thread_local_pool_resource::deallocate_bytes(void* p, size_t bytes, size_t alignment) noexcept {
+  size_t c = class_of(bytes, alignment);
+  if (c == n_size_classes) {
+    ::operator delete(p, bytes, std::align_val_t{alignment});
+    return;
+  }
+  if (cache_torn_down) {
+    push_without_cache(c, p);
+    return;
+  }
+  cache.push(c, p);
+}
+
+thread_local_pool_resource* thread_local_pool() noexcept {
+  static thread_local_pool_resource pool;
+  return &pool;
+}
+
+} // namespace untitled
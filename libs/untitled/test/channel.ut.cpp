@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "untitled/channel.hpp"
+
+#include <atomic>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(t_untitled)
+BOOST_AUTO_TEST_SUITE(channel)
+
+BOOST_AUTO_TEST_CASE(can_create_channel_with_power_of_two_capacity) {
+  BOOST_CHECK_EQUAL(untitled::spsc_channel<int>{0}.capacity(), 2);
+  BOOST_CHECK_EQUAL(untitled::spsc_channel<int>{8}.capacity(), 8);
+  BOOST_CHECK_EQUAL(untitled::spsc_channel<int>{9}.capacity(), 16);
+}
+
+BOOST_AUTO_TEST_CASE(can_push_and_pop_until_full_and_empty) {
+  untitled::spsc_channel<std::string> c{4};
+
+  for (int i = 0; i < 4; ++i) {
+    BOOST_REQUIRE(c.try_push(std::to_string(i)));
+  }
+  BOOST_CHECK(!c.try_push("full"));
+
+  std::string v;
+  for (int i = 0; i < 4; ++i) {
+    BOOST_REQUIRE(c.try_pop(v));
+    BOOST_CHECK_EQUAL(v, std::to_string(i));
+  }
+  BOOST_CHECK(!c.try_pop(v));
+}
+
+BOOST_AUTO_TEST_CASE(can_push_and_pop_in_batches) {
+  untitled::spsc_channel<int> c{8};
+
+  std::vector<int> in(12);
+  std::iota(in.begin(), in.end(), 0);
+  BOOST_CHECK_EQUAL(c.push_n(in.begin(), in.size()), 8);
+
+  std::vector<int> out(5);
+  BOOST_CHECK_EQUAL(c.pop_n(out.begin(), out.size()), 5);
+  BOOST_CHECK_EQUAL_COLLECTIONS(out.begin(), out.end(), in.begin(), in.begin() + 5);
+
+  // n.b. wraps around the end of the ring
+  BOOST_CHECK_EQUAL(c.push_n(in.begin() + 8, 4), 4);
+  out.resize(10);
+  BOOST_CHECK_EQUAL(c.pop_n(out.begin(), out.size()), 7);
+  BOOST_CHECK_EQUAL_COLLECTIONS(out.begin(), out.begin() + 7, in.begin() + 5, in.end());
+}
+
+BOOST_AUTO_TEST_CASE(can_transfer_between_threads_in_order) {
+  size_t n_items = 1'000'000;
+  untitled::spsc_channel<size_t, true> c{1024};
+
+  std::thread producer{[&c, n_items] {
+    for (size_t i = 0; i < n_items; ++i) {
+      c.push(i);
+    }
+  }};
+
+  size_t expected = 0;
+  std::vector<size_t> batch(64);
+  while (expected < n_items) {
+    size_t n = c.wait_pop_n(batch.begin(), batch.size());
+    for (size_t i = 0; i < n; ++i) {
+      BOOST_REQUIRE_EQUAL(batch[i], expected++);
+    }
+  }
+  producer.join();
+}
+
+BOOST_AUTO_TEST_CASE(can_cancel_waiting_consumer) {
+  untitled::spsc_channel<int, true> c{4};
+
+  // n.b. results are recorded by the consumer, and only checked after joining it (as checks are not thread-safe)
+  std::atomic<bool> popped{false};
+  bool popped_value = false;
+  bool popped_after = true;
+  int value         = 0;
+  std::thread consumer{[&] {
+    popped_value = c.pop(value);
+    popped       = true;
+    // n.b. cancelled either while waiting, or before starting to wait -- both must return false
+    int v        = 0;
+    popped_after = c.pop(v);
+  }};
+
+  c.push(42);
+  while (!popped) {
+    std::this_thread::yield();
+  }
+  c.cancel();
+  consumer.join();
+
+  BOOST_CHECK(popped_value);
+  BOOST_CHECK_EQUAL(value, 42);
+  BOOST_CHECK(!popped_after);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
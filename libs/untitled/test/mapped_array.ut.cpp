@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "untitled/mapped_array.hpp"
+
+#include <filesystem>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <boost/test/unit_test.hpp>
+
+// n.b. named uniquely (by process, and randomly), so that overlapping test runs do not collide
+struct temporary_file {
+  temporary_file(const char* name)
+      : path{std::filesystem::temp_directory_path() / (std::string{name} + "." + std::to_string(::getpid()) + "." + std::to_string(std::random_device{}()))} {}
+  ~temporary_file() { std::filesystem::remove(path); }
+  std::filesystem::path path;
+};
+
+BOOST_AUTO_TEST_SUITE(t_untitled)
+BOOST_AUTO_TEST_SUITE(mapped_array)
+
+BOOST_AUTO_TEST_CASE(can_default_create_mapped_array) {
+  untitled::mapped_array<int> a;
+  BOOST_CHECK(a.empty());
+  BOOST_CHECK_EQUAL(a.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(can_map_array_from_file) {
+  temporary_file f{"untitled.mapped_array.ints"};
+
+  std::vector<int> v(100'000);
+  std::iota(v.begin(), v.end(), 0);
+  untitled::mapped_array<int>::create(f.path, v);
+
+  untitled::mapped_array<int> a{f.path, {.advice = untitled::map_advice::sequential, .huge_pages = true}};
+  BOOST_CHECK(!a.writable());
+  BOOST_REQUIRE_EQUAL(a.size(), v.size());
+  BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), v.begin(), v.end());
+  BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(a.data()) % 64, 0);
+
+  a.advise(untitled::map_advice::random, 1'000, 10'000);
+  BOOST_CHECK_EQUAL(a[1'234], 1'234);
+
+  // n.b. ranges extending (or lying entirely) past the end are clamped (or ignored)
+  a.advise(untitled::map_advice::will_need, 99'000, 10'000);
+  a.advise(untitled::map_advice::will_need, a.size(), 10);
+  a.advise(untitled::map_advice::will_need, 10 * a.size(), 10);
+  a.advise(untitled::map_advice::will_need, 1'000, std::numeric_limits<size_t>::max());
+  a.advise(untitled::map_advice::will_need, std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max());
+  BOOST_CHECK_EQUAL(a[99'999], 99'999);
+}
+
+BOOST_AUTO_TEST_CASE(can_modify_copy_on_write_array_without_changing_file) {
+  temporary_file f{"untitled.mapped_array.doubles"};
+
+  std::vector<double> v{1.0, 2.0, 3.0};
+  untitled::mapped_array<double>::create(f.path, v);
+
+  {
+    untitled::mapped_array<double> a{f.path, {.mode = untitled::map_mode::copy_on_write}};
+    BOOST_CHECK(a.writable());
+    a.mutable_data()[1] = 42.0;
+    BOOST_CHECK_EQUAL(a[1], 42.0);
+  }
+
+  untitled::mapped_array<double> a{f.path};
+  BOOST_CHECK_EQUAL(a[1], 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(can_recreate_file_while_mapped) {
+  temporary_file f{"untitled.mapped_array.recreated"};
+
+  std::vector<int> v(100'000, 1);
+  untitled::mapped_array<int>::create(f.path, v);
+  untitled::mapped_array<int> a{f.path};
+
+  // n.b. the existing mapping keeps the previous contents (rather than faulting on a truncated file)
+  untitled::mapped_array<int>::create(f.path, std::vector<int>{2});
+  BOOST_REQUIRE_EQUAL(a.size(), v.size());
+  BOOST_CHECK_EQUAL(a[99'999], 1);
+
+  untitled::mapped_array<int> b{f.path};
+  BOOST_REQUIRE_EQUAL(b.size(), 1);
+  BOOST_CHECK_EQUAL(b[0], 2);
+}
+
+BOOST_AUTO_TEST_CASE(can_reject_file_with_mismatched_type) {
+  temporary_file f{"untitled.mapped_array.mismatch"};
+
+  std::vector<float> v{1.0f, 2.0f, 3.0f};
+  untitled::mapped_array<float>::create(f.path, v);
+
+  BOOST_CHECK_THROW(untitled::mapped_array<int>{f.path}, std::runtime_error);
+  BOOST_CHECK_THROW(untitled::mapped_array<double>{f.path}, std::runtime_error);
+  BOOST_CHECK_NO_THROW(untitled::mapped_array<float>{f.path});
+}
+
+BOOST_AUTO_TEST_CASE(can_reject_missing_file) {
+  BOOST_CHECK_THROW(untitled::mapped_array<int>{"/this/file/does/not/exist"}, std::system_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,224 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "untitled/memory.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "untitled/expected.hpp"
+#include "untitled/thread_pool.hpp"
+#include "untitled/variant.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+// Upstream resource that keeps track of the outstanding (and total) allocations
+struct counting_resource : std::pmr::memory_resource {
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    ++allocations;
+    ++total;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    --allocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+  std::atomic<int> allocations{0};
+  std::atomic<int> total{0};
+};
+
+BOOST_AUTO_TEST_SUITE(t_untitled)
+BOOST_AUTO_TEST_SUITE(memory)
+
+BOOST_AUTO_TEST_CASE(can_allocate_aligned_memory_from_arena) {
+  untitled::arena_resource arena{256};
+
+  for (size_t alignment : {1, 2, 4, 8, 16, 32, 64, 128}) {
+    void* p = arena.allocate(3, alignment);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(p) % alignment, 0);
+  }
+
+  // n.b. allocations larger than the chunk size are also served
+  void* p = arena.allocate(4096, 64);
+  BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(p) % 64, 0);
+}
+
+BOOST_AUTO_TEST_CASE(can_reset_and_release_arena) {
+  counting_resource upstream;
+  {
+    untitled::arena_resource arena{128, &upstream};
+
+    for (int i = 0; i < 100; ++i) {
+      [[maybe_unused]] void* p = arena.allocate(64);
+    }
+    BOOST_CHECK_GT(upstream.allocations.load(), 1);
+
+    arena.reset();
+    BOOST_CHECK_EQUAL(upstream.allocations.load(), 1);
+
+    // After reset, the kept chunk is reused
+    void* first = arena.allocate(8);
+    arena.reset();
+    BOOST_CHECK_EQUAL(arena.allocate(8), first);
+
+    arena.release();
+    BOOST_CHECK_EQUAL(upstream.allocations.load(), 0);
+
+    [[maybe_unused]] void* p = arena.allocate(8);
+  }
+  BOOST_CHECK_EQUAL(upstream.allocations.load(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(can_use_arena_with_containers_of_variant_and_expected) {
+  untitled::arena_resource arena;
+
+  std::pmr::vector<untitled::variant<int, double>> variants{&arena};
+  for (int i = 0; i < 1000; ++i) {
+    variants.emplace_back(int{i});
+  }
+  BOOST_CHECK_EQUAL(variants[999].get<int>(), 999);
+
+  std::vector<untitled::expected<int, long>, untitled::arena_allocator<untitled::expected<int, long>>> expecteds{arena};
+  for (int i = 0; i < 1000; ++i) {
+    expecteds.emplace_back(i);
+  }
+  BOOST_CHECK_EQUAL(expecteds[999].value(), 999);
+}
+
+BOOST_AUTO_TEST_CASE(can_allocate_from_thread_local_pool) {
+  std::vector<std::string, untitled::pool_allocator<std::string>> strings;
+  for (int i = 0; i < 1000; ++i) {
+    strings.push_back(std::string(100, 'a' + i % 26));
+  }
+  BOOST_CHECK_EQUAL(strings[999], std::string(100, 'a' + 999 % 26));
+
+  // n.b. large and over-aligned allocations are forwarded upstream
+  auto* pool = untitled::thread_local_pool();
+  void* large = pool->allocate(10'000, 256);
+  BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(large) % 256, 0);
+  pool->deallocate(large, 10'000, 256);
+}
+
+BOOST_AUTO_TEST_CASE(can_deallocate_on_different_thread_from_thread_local_pool) {
+  auto* pool     = untitled::thread_local_pool();
+  size_t n_items = 100'000;
+
+  std::vector<void*> blocks(n_items);
+  std::thread producer{[&] {
+    for (auto& b : blocks) {
+      b = pool->allocate(48);
+      std::memset(b, 0xff, 48);
+    }
+  }};
+  producer.join();
+
+  std::thread consumer{[&] {
+    for (auto& b : blocks) {
+      pool->deallocate(b, 48);
+    }
+  }};
+  consumer.join();
+
+  // Blocks released by the (terminated) consumer are reused by another thread
+  // n.b. a fresh thread starts with an empty cache, and so refills from the depot -- most recent batches first
+  std::vector<void*> reused(n_items);
+  std::thread reuser{[&] {
+    for (auto& b : reused) {
+      b = pool->allocate(48);
+    }
+  }};
+  reuser.join();
+
+  std::unordered_set<void*> released(blocks.begin(), blocks.end());
+  std::unordered_set<void*> allocated;
+  for (auto* b : reused) {
+    BOOST_REQUIRE(released.contains(b));
+    BOOST_REQUIRE(allocated.insert(b).second);
+  }
+  BOOST_CHECK_EQUAL(allocated.size(), n_items);
+
+  for (auto& b : reused) {
+    pool->deallocate(b, 48);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(can_deallocate_after_thread_local_pool_cache_is_destroyed) {
+  void* released = nullptr;
+  std::thread t{[&released] {
+    // n.b. constructed before (and thus destroyed after) the thread's cache, which is only created by the allocation
+    thread_local std::vector<int, untitled::pool_allocator<int>> late;
+    late.resize(100);
+    released = late.data();
+  }};
+  t.join();
+
+  // The block released after the cache was destroyed reaches the depot, and is reused by a fresh thread
+  void* reused = nullptr;
+  std::thread reuser{[&reused] {
+    auto* pool = untitled::thread_local_pool();
+    reused     = pool->allocate(100 * sizeof(int), alignof(int));
+    pool->deallocate(reused, 100 * sizeof(int), alignof(int));
+  }};
+  reuser.join();
+
+  BOOST_CHECK_EQUAL(reused, released);
+}
+
+BOOST_AUTO_TEST_CASE(can_use_thread_local_pool_for_thread_pool_tasks) {
+  size_t n_tasks = 10'000;
+  std::atomic<size_t> count{0};
+  {
+    untitled::thread_pool pool{4, untitled::thread_local_pool()};
+    for (size_t i = 0; i < n_tasks; ++i) {
+      pool.submit([&count]() { ++count; });
+    }
+  }
+  BOOST_CHECK_EQUAL(count.load(), n_tasks);
+}
+
+BOOST_AUTO_TEST_CASE(can_allocate_thread_pool_tasks_from_memory_resource) {
+  counting_resource resource;
+  size_t n_tasks = 1'000;
+  std::atomic<size_t> count{0};
+  {
+    untitled::thread_pool pool{2, &resource};
+
+    // n.b. tasks too large to be stored inline are allocated from the resource
+    std::array<size_t, 8> payload{1, 1, 1, 1, 1, 1, 1, 1};
+    int before = resource.total.load();
+    for (size_t i = 0; i < n_tasks; ++i) {
+      pool.submit([&count, payload]() { count += payload[0]; });
+    }
+    BOOST_CHECK_GE(resource.total.load() - before, int(n_tasks));
+
+    // n.b. including those submitted in bulk
+    std::vector<std::function<void()>> callables(n_tasks, [&count, payload]() { count += payload[0]; });
+    before = resource.total.load();
+    pool.submit_bulk(callables.begin(), callables.end());
+    BOOST_CHECK_GE(resource.total.load() - before, int(n_tasks));
+
+    // n.b. while the tasks of submit_n are stored inline (only the queue storage, and the shared function, are allocated)
+    before = resource.total.load();
+    pool.submit_n(n_tasks, [&count](size_t) { ++count; });
+    BOOST_CHECK_LT(resource.total.load() - before, int(n_tasks));
+  }
+  BOOST_CHECK_EQUAL(count.load(), 3 * n_tasks);
+  BOOST_CHECK_EQUAL(resource.allocations.load(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "untitled/segmented_array.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "untitled/memory.hpp"
+#include "untitled/thread_pool.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(t_untitled)
+BOOST_AUTO_TEST_SUITE(segmented_array)
+
+BOOST_AUTO_TEST_CASE(can_default_create_segmented_array) {
+  untitled::segmented_array<int> a;
+  BOOST_CHECK(a.empty());
+  BOOST_CHECK(a.begin() == a.end());
+}
+
+BOOST_AUTO_TEST_CASE(can_append_to_segmented_array_without_moving_elements) {
+  untitled::segmented_array<std::string> a;
+
+  auto& first = a.push_back("first");
+  for (int i = 1; i < 10'000; ++i) {
+    a.emplace_back(std::to_string(i));
+  }
+
+  BOOST_CHECK_EQUAL(a.size(), 10'000);
+  BOOST_CHECK_EQUAL(&a[0], &first);
+  BOOST_CHECK_EQUAL(first, "first");
+  for (int i = 1; i < 10'000; ++i) {
+    BOOST_REQUIRE_EQUAL(a[i], std::to_string(i));
+  }
+  BOOST_CHECK_EQUAL(std::distance(a.begin(), a.end()), 10'000);
+}
+
+BOOST_AUTO_TEST_CASE(can_append_copies_to_segmented_array) {
+  untitled::segmented_array<std::vector<std::string>> a;
+
+  std::vector<std::string> words{"a", "b", "c"};
+  a.push_back(words);
+  a.emplace_back(words.begin(), words.end());
+
+  BOOST_REQUIRE_EQUAL(a.size(), 2);
+  BOOST_CHECK(a[0] == words);
+  BOOST_CHECK(a[1] == words);
+}
+
+BOOST_AUTO_TEST_CASE(is_unchanged_by_throwing_append_to_segmented_array) {
+  struct throwing_copy {
+    int value;
+
+    explicit throwing_copy(int v) : value{v} {}
+    throwing_copy(const throwing_copy& other) : value{other.value} {
+      if (value < 0) {
+        throw std::runtime_error("copy failed");
+      }
+    }
+    throwing_copy(throwing_copy&&) noexcept = default;
+  };
+
+  untitled::segmented_array<throwing_copy> a;
+  throwing_copy good{1};
+  throwing_copy bad{-1};
+
+  a.push_back(good);
+  BOOST_CHECK_THROW(a.push_back(bad), std::runtime_error);
+  a.push_back(good);
+
+  BOOST_REQUIRE_EQUAL(a.size(), 2);
+  BOOST_CHECK_EQUAL(a[0].value, 1);
+  BOOST_CHECK_EQUAL(a[1].value, 1);
+}
+
+BOOST_AUTO_TEST_CASE(can_append_concurrently_to_segmented_array) {
+  size_t n_threads = 8;
+  size_t n_items   = 100'000;
+
+  untitled::segmented_array<size_t, untitled::pool_allocator<size_t>> a;
+  {
+    untitled::thread_pool pool{n_threads};
+    for (size_t t = 0; t < n_threads; ++t) {
+      pool.submit([t, n_items, &a]() {
+        for (size_t i = 0; i < n_items; ++i) {
+          a.push_back(t * n_items + i);
+        }
+      });
+    }
+    // n.b. stopping the pool acts as a barrier, after which all appends are visible
+  }
+
+  BOOST_REQUIRE_EQUAL(a.size(), n_threads * n_items);
+
+  std::vector<size_t> values(a.begin(), a.end());
+  std::sort(values.begin(), values.end());
+  std::vector<size_t> expected(n_threads * n_items);
+  std::iota(expected.begin(), expected.end(), 0);
+  BOOST_CHECK(values == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -8,9 +8,14 @@
 
 #include "untitled/thread_pool.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <random>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
@@ -126,5 +131,178 @@ BOOST_AUTO_TEST_CASE(can_sum_vector_on_thread_pool) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(can_submit_delayed_task_on_thread_pool) {
+  untitled::thread_pool pool{2};
+
+  auto submitted = std::chrono::steady_clock::now();
+  untitled::monitor<std::chrono::steady_clock::time_point> ran;
+  std::atomic<bool> done{false};
+  pool.submit_after(std::chrono::milliseconds(100), [&ran, &done]() {
+    ran([](auto& t) { t = std::chrono::steady_clock::now(); });
+    done = true;
+  });
+
+  wait_until([&done]() { return done.load(); });
+  BOOST_CHECK_GE(ran.get() - submitted, std::chrono::milliseconds(100));
+}
+
+BOOST_AUTO_TEST_CASE(never_runs_delayed_task_early_on_thread_pool) {
+  untitled::thread_pool pool{1};
+
+  // n.b. submitting at various offsets within a timer tick
+  for (int i = 0; i < 10; ++i) {
+    std::this_thread::sleep_for(std::chrono::microseconds(100 * i));
+
+    auto submitted = std::chrono::steady_clock::now();
+    untitled::monitor<std::chrono::steady_clock::time_point> ran;
+    std::atomic<bool> done{false};
+    pool.submit_after(std::chrono::milliseconds(5), [&ran, &done]() {
+      ran([](auto& t) { t = std::chrono::steady_clock::now(); });
+      done = true;
+    });
+
+    wait_until([&done]() { return done.load(); });
+    BOOST_CHECK_GE(ran.get() - submitted, std::chrono::milliseconds(5));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(can_submit_periodic_task_on_thread_pool) {
+  untitled::thread_pool pool{2};
+
+  std::atomic<int> count{0};
+  auto id = pool.submit_every(std::chrono::milliseconds(10), [&count]() { ++count; });
+
+  wait_until([&count]() { return count.load() >= 5; });
+  BOOST_CHECK(pool.cancel(id));
+  BOOST_CHECK(!pool.cancel(id));
+
+  // n.b. allow for an occurrence already submitted (but not yet executed) when cancelled
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  int after_cancel = count.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  BOOST_CHECK_EQUAL(count.load(), after_cancel);
+}
+
+BOOST_AUTO_TEST_CASE(can_keep_servicing_timers_when_copying_periodic_task_throws) {
+  // A periodic task whose every other copy (made by the timer thread, for each occurrence) throws
+  struct flaky_task {
+    std::atomic<int>* count;
+    std::shared_ptr<std::atomic<int>> copies = std::make_shared<std::atomic<int>>(0);
+
+    explicit flaky_task(std::atomic<int>* count) : count{count} {}
+    flaky_task(const flaky_task& other) : count{other.count}, copies{other.copies} {
+      if (++*copies % 2 == 1) {
+        throw std::runtime_error("copy failed");
+      }
+    }
+    flaky_task(flaky_task&&) noexcept = default;
+
+    void operator()() const { ++*count; }
+  };
+
+  untitled::thread_pool pool{2};
+
+  std::atomic<int> count{0};
+  auto id = pool.submit_every(std::chrono::milliseconds(5), flaky_task{&count});
+  wait_until([&count]() { return count.load() >= 3; });
+
+  std::atomic<bool> done{false};
+  pool.submit_after(std::chrono::milliseconds(5), [&done]() { done = true; });
+  wait_until([&done]() { return done.load(); });
+
+  BOOST_CHECK(pool.cancel(id));
+}
+
+BOOST_AUTO_TEST_CASE(can_cancel_many_delayed_tasks_on_thread_pool) {
+  untitled::thread_pool pool{2};
+
+  size_t n_timers = 200'000;
+  std::atomic<size_t> count{0};
+
+  std::vector<untitled::timer_id> ids;
+  ids.reserve(n_timers);
+  for (size_t i = 0; i < n_timers; ++i) {
+    ids.push_back(pool.submit_after(std::chrono::milliseconds(2'000 + i % 500), [&count]() { ++count; }));
+  }
+  // Cancel every other timer, and let the remaining ones run
+  for (size_t i = 0; i < n_timers; i += 2) {
+    BOOST_REQUIRE(pool.cancel(ids[i]));
+  }
+
+  wait_until([&count, n_timers]() { return count.load() == n_timers / 2; });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  BOOST_CHECK_EQUAL(count.load(), n_timers / 2);
+}
+
+BOOST_AUTO_TEST_CASE(can_stop_thread_pool_with_pending_timers) {
+  std::atomic<bool> ran{false};
+  {
+    untitled::thread_pool pool{2};
+    pool.submit_after(std::chrono::hours(1), [&ran]() { ran = true; });
+  }
+  BOOST_CHECK(!ran.load());
+}
+
+BOOST_AUTO_TEST_CASE(can_submit_bulk_tasks_on_thread_pool) {
+  size_t n_tasks = 10'000;
+  std::atomic<size_t> count{0};
+  {
+    untitled::thread_pool pool{4};
+
+    std::vector<untitled::thread_pool::task_t> tasks(n_tasks, [&count]() { ++count; });
+    pool.submit_bulk(tasks.begin(), tasks.end());
+    pool.submit_bulk(tasks.begin(), tasks.begin()); // n.b. empty batches are fine
+  }
+  BOOST_CHECK_EQUAL(count.load(), n_tasks);
+}
+
+BOOST_AUTO_TEST_CASE(can_submit_bulk_tasks_all_or_nothing_on_thread_pool) {
+  // A task whose copy throws, once the given number of copies have been made
+  struct throwing_task {
+    std::atomic<size_t>* count;
+    size_t* copies_left;
+
+    throwing_task(std::atomic<size_t>* count, size_t* copies_left) : count{count}, copies_left{copies_left} {}
+    throwing_task(const throwing_task& other) : count{other.count}, copies_left{other.copies_left} {
+      if (*copies_left == 0) {
+        throw std::runtime_error("copy failed");
+      }
+      --*copies_left;
+    }
+
+    void operator()() const { ++*count; }
+  };
+
+  std::atomic<size_t> count{0};
+  {
+    untitled::thread_pool pool{2};
+
+    size_t copies_left = size_t(-1);
+    std::vector<untitled::thread_pool::task_t> tasks;
+    for (size_t i = 0; i < 100; ++i) {
+      tasks.emplace_back(throwing_task{&count, &copies_left});
+    }
+
+    copies_left = 50;
+    BOOST_CHECK_THROW(pool.submit_bulk(tasks.begin(), tasks.end()), std::runtime_error);
+
+    copies_left = size_t(-1);
+    pool.submit_bulk(tasks.begin(), tasks.end());
+  }
+  BOOST_CHECK_EQUAL(count.load(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(can_submit_n_tasks_on_thread_pool) {
+  size_t n_tasks = 10'000;
+  std::vector<std::atomic<int>> calls(n_tasks);
+  {
+    untitled::thread_pool pool{4};
+    pool.submit_n(n_tasks, [&calls](size_t i) { ++calls[i]; });
+  }
+  for (size_t i = 0; i < n_tasks; ++i) {
+    BOOST_REQUIRE_EQUAL(calls[i].load(), 1);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
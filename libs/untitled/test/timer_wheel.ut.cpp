@@ -0,0 +1,145 @@
+//
+// Copyright (c) 2024 Marcos Bento
+//
+// Distributed under multiple licenses: Apache, MIT, Boost, Unlicense.
+//
+// See https://github.com/marcosbento/untitled
+//
+
+#include "untitled/timer_wheel.hpp"
+
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using wheel_t = untitled::timer_wheel<int>;
+
+// Advances the wheel, collecting (tick, payload) of the expired timers
+static std::vector<std::pair<wheel_t::tick_t, int>> advance(wheel_t& w, wheel_t::tick_t now) {
+  std::vector<std::pair<wheel_t::tick_t, int>> expired;
+  w.advance(now, [&expired](wheel_t::tick_t tick, int& v) -> std::optional<wheel_t::tick_t> {
+    expired.emplace_back(tick, v);
+    return std::nullopt;
+  });
+  return expired;
+}
+
+BOOST_AUTO_TEST_SUITE(t_untitled)
+BOOST_AUTO_TEST_SUITE(timer_wheel)
+
+BOOST_AUTO_TEST_CASE(can_default_create_timer_wheel) {
+  wheel_t w;
+  BOOST_CHECK(w.empty());
+  BOOST_CHECK(!w.next_tick());
+}
+
+BOOST_AUTO_TEST_CASE(can_expire_timers_in_order) {
+  wheel_t w{1'000};
+
+  std::vector<wheel_t::tick_t> delays = {1, 2, 63, 64, 65, 4'095, 4'096, 4'097, 262'144, 1'000'000};
+  for (auto delay : delays) {
+    w.schedule(1'000 + delay, int(delay));
+  }
+  BOOST_CHECK_EQUAL(w.size(), delays.size());
+
+  // n.b. advancing in (irregular) steps, which do not necessarily hit the expiry ticks
+  std::vector<std::pair<wheel_t::tick_t, int>> expired;
+  for (wheel_t::tick_t now = 1'000; now < 1'000 + 1'000'000 + 7; now += 7) {
+    auto e = advance(w, now);
+    expired.insert(expired.end(), e.begin(), e.end());
+  }
+  BOOST_REQUIRE_EQUAL(expired.size(), delays.size());
+  for (size_t i = 0; i < delays.size(); ++i) {
+    BOOST_CHECK_EQUAL(expired[i].first, 1'000 + delays[i]);
+    BOOST_CHECK_EQUAL(expired[i].second, int(delays[i]));
+  }
+  BOOST_CHECK(w.empty());
+}
+
+BOOST_AUTO_TEST_CASE(can_expire_random_timers_at_their_exact_tick) {
+  wheel_t w;
+
+  std::mt19937 gen{42};
+  std::uniform_int_distribution<wheel_t::tick_t> dist{1, 5'000'000};
+  std::vector<wheel_t::tick_t> expiries(10'000);
+  for (size_t i = 0; i < expiries.size(); ++i) {
+    expiries[i] = dist(gen);
+    w.schedule(expiries[i], int(i));
+  }
+
+  auto expired = advance(w, 5'000'000);
+  BOOST_REQUIRE_EQUAL(expired.size(), expiries.size());
+  for (size_t i = 0; i < expired.size(); ++i) {
+    BOOST_REQUIRE_EQUAL(expired[i].first, expiries[expired[i].second]);
+    if (i > 0) {
+      BOOST_REQUIRE_LE(expired[i - 1].first, expired[i].first);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(can_expire_timers_beyond_range_of_wheel) {
+  wheel_t w;
+
+  wheel_t::tick_t far = (wheel_t::tick_t(1) << 40) + 12'345;
+  w.schedule(far, 42);
+
+  BOOST_CHECK(advance(w, far - 1).empty());
+  auto expired = advance(w, far);
+  BOOST_REQUIRE_EQUAL(expired.size(), 1);
+  BOOST_CHECK_EQUAL(expired[0].first, far);
+}
+
+BOOST_AUTO_TEST_CASE(can_expire_past_timers_on_next_advance) {
+  wheel_t w{100};
+  w.schedule(10, 1);
+
+  auto expired = advance(w, 101);
+  BOOST_REQUIRE_EQUAL(expired.size(), 1);
+  BOOST_CHECK_EQUAL(expired[0].first, 101);
+}
+
+BOOST_AUTO_TEST_CASE(can_cancel_timers) {
+  wheel_t w;
+
+  auto a = w.schedule(10, 1);
+  auto b = w.schedule(10, 2);
+  auto c = w.schedule(5'000, 3);
+
+  BOOST_CHECK(w.cancel(b));
+  BOOST_CHECK(!w.cancel(b));
+  BOOST_CHECK(w.cancel(c));
+  BOOST_CHECK_EQUAL(w.size(), 1);
+
+  auto expired = advance(w, 10'000);
+  BOOST_REQUIRE_EQUAL(expired.size(), 1);
+  BOOST_CHECK_EQUAL(expired[0].second, 1);
+
+  // n.b. identifiers of expired timers are stale, even if their storage is reused
+  auto d = w.schedule(20'000, 4);
+  BOOST_CHECK_EQUAL(d.index, a.index);
+  BOOST_CHECK(!w.cancel(a));
+  BOOST_CHECK(w.cancel(d));
+  BOOST_CHECK(w.empty());
+}
+
+BOOST_AUTO_TEST_CASE(can_reschedule_periodic_timers) {
+  wheel_t w;
+
+  auto id = w.schedule(100, 0);
+
+  std::vector<wheel_t::tick_t> ticks;
+  w.advance(1'000, [&ticks](wheel_t::tick_t tick, int&) -> std::optional<wheel_t::tick_t> {
+    ticks.push_back(tick);
+    return tick + 300;
+  });
+  BOOST_CHECK(ticks == (std::vector<wheel_t::tick_t>{100, 400, 700, 1'000}));
+
+  BOOST_CHECK(w.cancel(id));
+  BOOST_CHECK(w.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()